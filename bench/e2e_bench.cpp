@@ -0,0 +1,404 @@
+// End-to-end benchmark of the whole AudioFilterSim flow: load, frame, FFT, noise estimation, Wiener
+// filter, overlap-add and writing of the outputs, run through denoiseFile() over a corpus of inputs of
+// different lengths. Reports the real-time factor, the wall time of each stage and the peak RSS as
+// JSON, and optionally compares the real-time factors against a baseline written by an earlier run.
+//
+// Usage: AudioFilterE2EBench [bench options] [AudioFilterSim options]
+// The AudioFilterSim options (--frame, --overlap, --taps, --binary, --block, ...) select the
+// configuration benchmarked; its outputs go to <--out>/e2e_bench and are removed afterwards.
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "fileio.hpp"
+#include "pipeline.hpp"
+#include "run_config.hpp"
+#include "stage_timer.hpp"
+#include "wiener_kernel.hpp"
+#include "window.hpp"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* kUsage =
+    "Usage: AudioFilterE2EBench [options] [AudioFilterSim options]\n"
+    "  --inputs=PATH       Manifest file or directory of inputs, as --batch (default: a synthetic corpus)\n"
+    "  --lengths=S,S,...   Durations in seconds of the synthetic inputs (default 1,10,60)\n"
+    "  --repeat=N          Runs of each measurement, the fastest is kept (default 3)\n"
+    "  --json=FILE         Write the JSON report to FILE instead of stdout\n"
+    "  --baseline=FILE     Compare the real-time factors with a JSON report of an earlier run\n"
+    "  --tolerance=PCT     Slowdown over the baseline reported as a regression (default 10)\n";
+
+struct BenchOptions {
+    std::string inputs;
+    std::vector<double> lengths{1.0, 10.0, 60.0};
+    size_t repeat = 3;
+    std::string json_path;
+    std::string baseline_path;
+    double tolerance = 0.10;
+};
+
+// Timings of one input, in seconds
+struct Measurement {
+    std::string name;
+    std::string path;
+    size_t samples = 0;                 // Interleaved samples of all channels
+    size_t channels = 1;
+    double sample_rate = 0.0;
+    size_t frames = 0;
+    double load = 0.0;                  // Decoding of the whole input
+    double process = 0.0;               // Framing, FFT, estimator, Wiener filter, IFFT and overlap-add
+    double write = 0.0;                 // Writing of the requested outputs
+    double wall = 0.0;                  // Whole denoiseFile() run
+    std::vector<StageSummary> hot_path;  // Stage timers over the full runs, when compiled in
+
+    double audioSeconds() const { return static_cast<double>(samples) / channels / sample_rate; }
+    double rtf() const { return wall / audioSeconds(); }
+};
+
+// Peak resident set size of the process so far, in KiB
+long peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<long>(usage.ru_maxrss / 1024);          // Bytes on macOS
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Fastest of repeat runs of fn, in seconds
+double fastest(const std::function<void()>& fn, size_t repeat) {
+    double best = 0.0;
+    for (size_t i = 0; i < repeat; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+// Raw int16 noisy chirp of the given duration, interleaved for several channels
+void writeSyntheticInput(const std::string& path, double seconds, size_t rate, size_t channels) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not create " + path);
+    }
+    std::mt19937 rng(static_cast<unsigned>(seconds * 1000));
+    std::normal_distribution<double> noise(0.0, 0.05);
+    const size_t length = static_cast<size_t>(seconds * rate);
+    std::vector<int16_t> chunk;
+    chunk.reserve(4096 * channels);
+    for (size_t i = 0; i < length; i++) {
+        const double t = static_cast<double>(i) / rate;
+        const double tone = 0.3 * std::sin(2.0 * 3.14159265358979323846 * (200.0 + 50.0 * t) * t);
+        for (size_t c = 0; c < channels; c++) {
+            const double x = std::max(-1.0, std::min(1.0, tone + noise(rng)));
+            chunk.push_back(static_cast<int16_t>(std::lround(x * 32767.0)));
+        }
+        if (chunk.size() == chunk.capacity() || i + 1 == length) {
+            file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(int16_t));
+            chunk.clear();
+        }
+    }
+}
+
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (const char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+const char* modeName(const RunConfig& config) {
+    if (config.live) return "live";
+    if (config.realtime) return "realtime";
+    return config.block_frames > 1 ? "block" : "frame";
+}
+
+void writeJson(std::ostream& out, const RunConfig& config, size_t frame_size, size_t hop, size_t repeat,
+               const std::vector<Measurement>& runs) {
+    char number[64];
+    auto fmt = [&](double value) { std::snprintf(number, sizeof(number), "%.6g", value); return std::string(number); };
+
+    out << "{\n";
+    out << "  \"benchmark\": \"AudioFilterE2EBench\",\n";
+    out << "  \"config\": {\"frame_size\": " << frame_size << ", \"hop\": " << hop
+        << ", \"window\": " << jsonString(config.window_file.empty() ? windowTypeName(config.window) : config.window_file)
+        << ", \"precision\": \"" << (config.single_precision ? "float" : "double") << "\""
+        << ", \"noise_window\": " << config.noise_window << ", \"mode\": \"" << modeName(config) << "\""
+        << ", \"block_frames\": " << config.block_frames << ", \"jobs\": " << config.jobs
+        << ", \"format\": \"" << (config.format == OutputFormat::Binary ? "binary" : "text") << "\""
+        << ", \"taps\": " << config.taps << ", \"wiener_kernel\": \"" << simdLevelName(detectSimdLevel()) << "\""
+        << ", \"repeat\": " << repeat << "},\n";
+    out << "  \"inputs\": [\n";
+    double audio = 0.0, wall = 0.0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Measurement& m = runs[i];
+        out << "    {\"name\": " << jsonString(m.name) << ", \"samples\": " << m.samples
+            << ", \"channels\": " << m.channels << ", \"audio_seconds\": " << fmt(m.audioSeconds())
+            << ", \"frames\": " << m.frames << ", \"wall_seconds\": " << fmt(m.wall) << ", \"rtf\": " << fmt(m.rtf())
+            << ", \"stages\": {\"load\": " << fmt(m.load) << ", \"process\": " << fmt(m.process)
+            << ", \"write\": " << fmt(m.write) << "}";
+        if (!m.hot_path.empty()) {
+            // Seconds per full run and mean/p99 of a call in microseconds of each timed stage
+            out << ", \"hot_path\": {";
+            bool first = true;
+            for (const StageSummary& stage : m.hot_path) {
+                if (stage.count == 0) continue;
+                out << (first ? "" : ", ") << "\"" << stageName(stage.stage) << "\": {\"seconds\": "
+                    << fmt(stage.total * 1e-9 / repeat) << ", \"mean_us\": " << fmt(stage.mean * 1e-3)
+                    << ", \"p99_us\": " << fmt(stage.p99 * 1e-3) << "}";
+                first = false;
+            }
+            out << "}";
+        }
+        out << "}"
+            << (i + 1 < runs.size() ? ",\n" : "\n");
+        audio += m.audioSeconds();
+        wall += m.wall;
+    }
+    out << "  ],\n";
+    // getrusage() keeps one high-water mark per process, so the peak RSS covers the whole benchmark
+    const long peak = peakRssKb();
+    out << "  \"total\": {\"audio_seconds\": " << fmt(audio) << ", \"wall_seconds\": " << fmt(wall)
+        << ", \"rtf\": " << fmt(audio > 0.0 ? wall / audio : 0.0) << ", \"peak_rss_kb\": " << peak << "}\n";
+    out << "}\n";
+}
+
+// Real-time factors of a JSON report written by writeJson, by input name, the total under "total"
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open baseline: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    std::map<std::string, double> rtf;
+    std::string current;
+    size_t pos = 0;
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        const size_t end = text.find('"', pos + 1);
+        if (end == std::string::npos) break;
+        const std::string key = text.substr(pos + 1, end - pos - 1);
+        pos = text.find_first_not_of(" \t\r\n", end + 1);
+        if (pos == std::string::npos || text[pos] != ':') continue;   // A string value, not a key
+        pos = text.find_first_not_of(" \t\r\n", pos + 1);
+        if (pos == std::string::npos) break;
+        if (key == "name" && text[pos] == '"') {
+            const size_t value_end = text.find('"', pos + 1);
+            current = text.substr(pos + 1, value_end - pos - 1);
+            pos = value_end + 1;
+        } else if (key == "total") {
+            current = "total";
+        } else if (key == "rtf") {
+            rtf[current] = std::strtod(text.c_str() + pos, nullptr);
+        }
+    }
+    return rtf;
+}
+
+// Prints the comparison with the baseline on stderr, returns the number of regressions
+size_t compareWithBaseline(const std::vector<Measurement>& runs, const BenchOptions& opt) {
+    const std::map<std::string, double> baseline = readBaseline(opt.baseline_path);
+    double audio = 0.0, wall = 0.0;
+    std::vector<std::pair<std::string, double>> current;
+    for (const Measurement& m : runs) {
+        current.emplace_back(m.name, m.rtf());
+        audio += m.audioSeconds();
+        wall += m.wall;
+    }
+    current.emplace_back("total", wall / audio);
+
+    size_t regressions = 0;
+    std::fprintf(stderr, "%-24s %12s %12s %9s\n", "input", "baseline", "rtf", "change");
+    for (const auto& [name, rtf] : current) {
+        const auto it = baseline.find(name);
+        if (it == baseline.end() || it->second <= 0.0) {
+            std::fprintf(stderr, "%-24s %12s %12.6f %9s\n", name.c_str(), "-", rtf, "new");
+            continue;
+        }
+        const double change = rtf / it->second - 1.0;
+        const bool regressed = change > opt.tolerance;
+        regressions += regressed;
+        std::fprintf(stderr, "%-24s %12.6f %12.6f %+8.1f%%%s\n", name.c_str(), it->second, rtf, change * 100.0,
+                     regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+std::vector<double> parseLengths(const std::string& value) {
+    std::vector<double> lengths;
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        const double seconds = std::stod(item);
+        if (!(seconds > 0.0)) {
+            throw std::invalid_argument("--lengths must be positive durations: " + value);
+        }
+        lengths.push_back(seconds);
+    }
+    return lengths;
+}
+
+// Takes the benchmark options out of argv, the other arguments are left for parseRunConfig
+BenchOptions parseOptions(int argc, char* argv[], std::vector<char*>& rest) {
+    BenchOptions opt;
+    rest.push_back(argv[0]);
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string option = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+        try {
+            if (option == "--inputs" && !value.empty()) {
+                opt.inputs = value;
+            } else if (option == "--lengths" && !value.empty()) {
+                opt.lengths = parseLengths(value);
+            } else if (option == "--repeat" && !value.empty()) {
+                opt.repeat = std::max<size_t>(1, std::stoul(value));
+            } else if (option == "--json" && !value.empty()) {
+                opt.json_path = value;
+            } else if (option == "--baseline" && !value.empty()) {
+                opt.baseline_path = value;
+            } else if (option == "--tolerance" && !value.empty()) {
+                opt.tolerance = std::stod(value) / 100.0;
+            } else {
+                rest.push_back(argv[i]);
+            }
+        } catch (const std::invalid_argument&) {
+            throw std::invalid_argument("Invalid value for " + option + ": " + value);
+        }
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    RunConfig config;
+    try {
+        std::vector<char*> rest;
+        opt = parseOptions(argc, argv, rest);
+        config = parseRunConfig(static_cast<int>(rest.size()), rest.data());
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << kUsage << runConfigUsage();
+        return 1;
+    }
+
+    try {
+        const std::vector<float> window = makeAnalysisWindow(config);
+        const size_t hop = window.size() / config.overlap;
+        const fs::path work_dir = fs::path(config.output_dir) / "e2e_bench";
+        fs::create_directories(work_dir);
+
+        // Inputs: the given corpus, or synthetic raw int16 files of each length
+        std::vector<std::string> inputs;
+        if (!opt.inputs.empty()) {
+            inputs = listBatchInputs(opt.inputs);
+        } else {
+            const fs::path corpus = work_dir / "corpus";
+            fs::create_directories(corpus);
+            for (const double seconds : opt.lengths) {
+                char name[64];
+                std::snprintf(name, sizeof(name), "synthetic_%gs.pcm", seconds);
+                const std::string path = (corpus / name).string();
+                writeSyntheticInput(path, seconds, config.sample_rate, config.channels);
+                inputs.push_back(path);
+            }
+        }
+        if (inputs.empty()) {
+            throw std::runtime_error("No inputs to benchmark");
+        }
+
+        // The stages are timed in three runs of each input: decoding only, denoising without outputs
+        // and the full run. The process and write stages are the differences between them.
+        std::vector<Measurement> runs;
+        for (const std::string& input : inputs) {
+            Measurement m;
+            m.name = fs::path(input).stem().string();
+            m.path = input;
+
+            RunConfig run = config;
+            run.input_file = input;
+            run.output_dir = (work_dir / "outputs").string();
+            RunConfig silent = run;
+            silent.taps = TapNone;
+
+            m.load = fastest([&] {
+                auto source = openSampleSource(input, config.channels);
+                std::vector<float> chunk(1 << 16);
+                size_t samples = 0;
+                while (size_t n = source->read(chunk.data(), chunk.size())) samples += n;
+                m.samples = samples;
+                m.channels = source->channels();
+                m.sample_rate = source->sampleRate() ? source->sampleRate() : static_cast<double>(config.sample_rate);
+            }, opt.repeat);
+            if (m.samples == 0) {
+                throw std::runtime_error("Empty input: " + input);
+            }
+            const double denoise = fastest([&] { denoiseFile(silent, window, hop, config.noise_window); }, opt.repeat);
+            resetStageTimers();
+            m.wall = fastest([&] { m.frames = denoiseFile(run, window, hop, config.noise_window); }, opt.repeat);
+            if (kStageTimersEnabled) m.hot_path = stageSummary();
+            m.process = std::max(0.0, denoise - m.load);
+            m.write = std::max(0.0, m.wall - denoise);
+            runs.push_back(m);
+            std::fprintf(stderr, "--- %s: %.2f s of audio in %.4f s, RTF %.6f\n", m.name.c_str(), m.audioSeconds(),
+                         m.wall, m.rtf());
+        }
+        fs::remove_all(work_dir);
+
+        if (opt.json_path.empty()) {
+            writeJson(std::cout, config, window.size(), hop, opt.repeat, runs);
+        } else {
+            std::ofstream json(opt.json_path);
+            if (!json) {
+                throw std::runtime_error("Could not create " + opt.json_path);
+            }
+            writeJson(json, config, window.size(), hop, opt.repeat, runs);
+        }
+
+        if (!opt.baseline_path.empty() && compareWithBaseline(runs, opt) > 0) {
+            std::fprintf(stderr, "--- Slower than the baseline by more than %.1f%%\n", opt.tolerance * 100.0);
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+// Micro-benchmarks of each denoising stage in isolation: windowing, forward FFT, scaling + PSD, noise
+// estimation, Wiener filter, inverse FFT, overlap-add, and the whole DenoiseEngine frame for reference.
+// Every stage runs on the library code itself, across frame sizes 128-8192 and, for the noise
+// estimator, minimum statistics windows d of 16-512 frames.
+//
+// Usage: AudioFilterStageBench [--min-time=MS] [--rate=HZ] [--stage=NAME] [--precision=double|float]
+// Reports ns per frame and the real-time factor, i.e. the processing time of a frame divided by the
+// duration of the hop it advances (50% overlap at --rate); below 1 is faster than real time.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "audio_processing.hpp"
+#include "denoise_engine.hpp"
+#include "fft_engine.hpp"
+#include "frame.hpp"
+#include "window.hpp"
+
+namespace {
+
+// Keeps the compiler from discarding the results of a timed loop
+inline void doNotOptimize(const void* p) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
+
+struct BenchOptions {
+    double min_seconds = 0.05;          // Minimum duration of one timed repetition
+    double sample_rate = 48000.0;
+    std::string stage;                  // Only run this stage, empty for all
+    bool single_precision = false;      // Time the float chain instead of the double one
+};
+
+// Median ns per call of fn over 5 repetitions, each long enough to last opt.min_seconds
+double nsPerCall(const std::function<void()>& fn, const BenchOptions& opt) {
+    using clock = std::chrono::steady_clock;
+    fn();                                                       // Warm caches and lazy state
+    size_t iterations = 1;
+    while (true) {
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; i++) fn();
+        if (std::chrono::duration<double>(clock::now() - start).count() >= opt.min_seconds) break;
+        iterations *= 2;
+    }
+    std::vector<double> samples;
+    for (int rep = 0; rep < 5; rep++) {
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; i++) fn();
+        samples.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void report(const BenchOptions& opt, const char* stage, size_t frame_size, size_t d, double ns) {
+    const double hop_ns = (frame_size / 2) / opt.sample_rate * 1e9;
+    char d_text[24] = "-";                  // Room for any size_t
+    if (d > 0) std::snprintf(d_text, sizeof(d_text), "%zu", d);
+    std::printf("%-10s %6zu %5s %14.1f %12.6f\n", stage, frame_size, d_text, ns, ns / hop_ns);
+    std::fflush(stdout);
+}
+
+bool selected(const BenchOptions& opt, const char* stage) {
+    return opt.stage.empty() || opt.stage == stage;
+}
+
+template <typename T>
+void benchFrameSize(const BenchOptions& opt, size_t frame_size) {
+    const size_t hop = frame_size / 2;
+    const size_t bins = (frame_size / 2) + 1;
+    const std::vector<float> window = makeWindow(WindowType::Hann, frame_size, hop);
+
+    // Noisy tone, long enough for many distinct frames
+    std::mt19937 rng(frame_size);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> signal(64 * frame_size);
+    for (size_t i = 0; i < signal.size(); i++) {
+        signal[i] = 0.3f * static_cast<float>(std::sin(0.05 * i)) + noise(rng);
+    }
+    const size_t num_frames = (signal.size() - frame_size) / hop + 1;
+    size_t next = 0;
+    auto nextFrame = [&]() { const float* p = &signal[next * hop]; next = (next + 1) % num_frames; return p; };
+
+    BasicFrame<T> frame(frame_size, window);
+    BasicFFTEngine<T> fft(frame_size);
+    std::vector<T> windowed(frame_size);
+    std::vector<std::complex<T>> spectrum(bins);
+    std::vector<T> psd(bins);
+    std::vector<std::complex<T>> filtered(bins);
+    std::vector<T> recon(frame_size);
+    std::vector<T> acc(frame_size, 0);
+    std::vector<T> out(hop);
+
+    // Realistic inputs for the later stages: the spectra and PSDs of all frames of the signal
+    std::vector<std::complex<T>> spectra(num_frames * bins);
+    std::vector<T> psds(num_frames * bins);
+    for (size_t f = 0; f < num_frames; f++) {
+        frame.generateFrame(&signal[f * hop], windowed.data());
+        fft.forward(windowed.data(), &spectra[f * bins]);
+        scaleSpectrum(&spectra[f * bins], &psds[f * bins], frame_size);
+    }
+    auto nextIndex = [&]() { const size_t f = next; next = (next + 1) % num_frames; return f; };
+
+    if (selected(opt, "window")) {
+        report(opt, "window", frame_size, 0, nsPerCall([&] {
+            frame.generateFrame(nextFrame(), windowed.data());
+            doNotOptimize(windowed.data());
+        }, opt));
+    }
+    if (selected(opt, "fft")) {
+        report(opt, "fft", frame_size, 0, nsPerCall([&] {
+            fft.forward(windowed.data(), spectrum.data());
+            doNotOptimize(spectrum.data());
+        }, opt));
+    }
+    if (selected(opt, "psd")) {
+        // Scaling is in place, so the timing includes restoring an unscaled spectrum
+        report(opt, "psd", frame_size, 0, nsPerCall([&] {
+            const size_t f = nextIndex();
+            std::copy(&spectra[f * bins], &spectra[f * bins] + bins, spectrum.begin());
+            scaleSpectrum(spectrum.data(), psd.data(), frame_size);
+            doNotOptimize(psd.data());
+        }, opt));
+    }
+    if (selected(opt, "noise")) {
+        for (size_t d : {16, 64, 128, 512}) {
+            BasicNoiseEstimator<T> estimator(bins, d);
+            report(opt, "noise", frame_size, d, nsPerCall([&] {
+                estimator.update(&psds[nextIndex() * bins]);
+                doNotOptimize(estimator.getNoiseEstimate().data());
+            }, opt));
+        }
+    }
+    if (selected(opt, "wiener")) {
+        BasicWienerFilter<T> filter(frame_size);
+        BasicNoiseEstimator<T> estimator(bins, 64);
+        estimator.update(psds.data());
+        const T* noise_psd = estimator.getNoiseEstimate().data();
+        report(opt, "wiener", frame_size, 0, nsPerCall([&] {
+            const size_t f = nextIndex();
+            filter.apply(&spectra[f * bins], &psds[f * bins], noise_psd, filtered.data());
+            doNotOptimize(filtered.data());
+        }, opt));
+    }
+    if (selected(opt, "ifft")) {
+        std::copy(spectra.begin(), spectra.begin() + bins, filtered.begin());
+        report(opt, "ifft", frame_size, 0, nsPerCall([&] {
+            fft.inverse(filtered.data(), recon.data());
+            doNotOptimize(recon.data());
+        }, opt));
+    }
+    if (selected(opt, "ola")) {
+        report(opt, "ola", frame_size, 0, nsPerCall([&] {
+            overlapAdd(recon.data(), acc.data(), frame_size, hop, false, out.data());
+            doNotOptimize(out.data());
+        }, opt));
+    }
+    if (selected(opt, "frame")) {
+        BasicDenoiseEngine<T> engine(window, hop, 64);
+        report(opt, "frame", frame_size, 64, nsPerCall([&] {
+            engine.processFrame(nextFrame(), out.data());
+            doNotOptimize(out.data());
+        }, opt));
+    }
+}
+
+BenchOptions parseOptions(int argc, char* argv[]) {
+    BenchOptions opt;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string option = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+        if (option == "--min-time" && !value.empty()) {
+            opt.min_seconds = std::stod(value) / 1000.0;
+        } else if (option == "--rate" && !value.empty()) {
+            opt.sample_rate = std::stod(value);
+        } else if (option == "--stage" && !value.empty()) {
+            opt.stage = value;
+        } else if (option == "--precision" && (value == "double" || value == "float")) {
+            opt.single_precision = (value == "float");
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    try {
+        opt = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\nUsage: AudioFilterStageBench [--min-time=MS] [--rate=HZ] "
+                             "[--stage=window|fft|psd|noise|wiener|ifft|ola|frame] [--precision=double|float]\n", e.what());
+        return 1;
+    }
+
+    std::printf("Wiener kernel: %s, %s precision, real-time factor against a hop of N/2 at %.0f Hz\n",
+                simdLevelName(detectSimdLevel()), opt.single_precision ? "single" : "double", opt.sample_rate);
+    std::printf("%-10s %6s %5s %14s %12s\n", "stage", "N", "d", "ns/frame", "RTF");
+    for (size_t frame_size = 128; frame_size <= 8192; frame_size *= 2) {
+        if (opt.single_precision) {
+            benchFrameSize<float>(opt, frame_size);
+        } else {
+            benchFrameSize<double>(opt, frame_size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Cache line size used to align SIMD-friendly buffers
+constexpr size_t kCacheLine = 64;
+
+// Allocator returning cache-line aligned storage, for std::vector buffers walked by vectorized loops
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kCacheLine)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(kCacheLine));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using aligned_vector = std::vector<T, AlignedAllocator<T>>;
+
+// Rounds a count of elements up so rows of that many T start on a cache line
+template <typename T>
+constexpr size_t paddedCount(size_t n) {
+    constexpr size_t per_line = kCacheLine / sizeof(T);
+    return (n + per_line - 1) / per_line * per_line;
+}
@@ -4,32 +4,164 @@
 #include <complex>
 #include <algorithm>
 #include <iostream>
+#include <type_traits>
+#include "aligned_allocator.hpp"
+#include "wiener_kernel.hpp"
 
-class NoiseEstimator{
+// The estimator, the filter and the helpers below run in precision T: double for the reference chain,
+// float for the single-precision one.
+template <typename T>
+class BasicNoiseEstimator{
     private:
         size_t num_bins;
         size_t d;
 
-        std::vector<double> psd_smoothed;
-        std::vector<std::vector<double>> psd_history_buffer;  
-        std::vector<double> psd_noise_est;
-        std::vector<double> bias_comp;                
-        size_t idx;                                 
+        aligned_vector<T> psd_smoothed;
+        std::vector<T> psd_noise_est;
+        T bias_comp;                                // Minimum statistics bias compensation
+
+        // History of the smoothed PSD as one cache-aligned ring of d rows laid out [frame][bin].
+        // The sliding minimum over the last d frames follows van Herk/Gil-Werman: frames are grouped
+        // in blocks of d, rows before pos hold the current block and rows after pos hold the suffix
+        // minima of the previous block, so min(prefix, suffix[pos+1]) is the exact window minimum.
+        size_t stride;                              // Row length, num_bins padded to a cache line
+        aligned_vector<T> psd_history_buffer;
+        aligned_vector<T> psd_prefix_min;           // Running minimum of each bin over the current block
+        size_t pos;                                 // Row of the current frame within the block
     public:  
-        NoiseEstimator(size_t num_bins_param, size_t d_param);
-        void update(const std::vector<double>& current_power_spectrum);
-        const std::vector<double>& getNoiseEstimate() const;
+        BasicNoiseEstimator(size_t num_bins_param, size_t d_param);
+        void update(const std::vector<T>& current_power_spectrum) { update(current_power_spectrum.data()); }
+        void update(const T* current_power_spectrum) { updateBins(current_power_spectrum, 0, num_bins); advance(); }
+        // update() split by bins: the bin ranges of one frame are independent and may run on different
+        // threads, advance() must follow once all of them are done
+        void updateBins(const T* current_power_spectrum, size_t first, size_t last);
+        void advance();
+        size_t binCount() const { return num_bins; }
+        const std::vector<T>& getNoiseEstimate() const;
 };
 
-class WienerFilter{
+template <typename T>
+class BasicWienerFilter{
     private: 
         size_t frame_size;
-        std::vector<double> p_xi;
-        std::vector<double> p_wiener_gain;
-        std::vector<double> p_SNR;
+        size_t num_bins;                            // frame_size/2 + 1 bins per channel, channel after channel
+        aligned_vector<T> p_xi;
+        aligned_vector<T> p_wiener_gain;
+        aligned_vector<T> p_SNR;
+        BasicWienerGainKernel<T> kernel;            // Per-bin gain loop for the selected instruction set
     public:
-        WienerFilter(size_t frame_size_param);
-        std::vector<std::complex<double>> apply(const std::vector<std::complex<double>>& current_frame,
-        const std::vector<double>& psd, const std::vector<double>& psd_noise_est);
+        // channels independent spectra are filtered in one pass, laid out channel-major ([channel][bin])
+        BasicWienerFilter(size_t frame_size_param, size_t channels = 1, SimdLevel simd = detectSimdLevel());
+        std::vector<std::complex<T>> apply(const std::vector<std::complex<T>>& current_frame,
+        const std::vector<T>& psd, const std::vector<T>& psd_noise_est);
+        // Writes the filtered spectrum into a caller-provided buffer of channels * (frame_size/2 + 1) bins.
+        // filtered_frame may alias current_frame to filter the spectrum in place.
+        void apply(const std::complex<T>* current_frame, const T* psd,
+        const T* psd_noise_est, std::complex<T>* filtered_frame) {
+            applyBins(0, num_bins, current_frame, psd, psd_noise_est, filtered_frame);
+        }
+        // Filters bins [first, last) only, the pointers still address bin 0. Bins are independent, so
+        // disjoint ranges may run on different threads.
+        void applyBins(size_t first, size_t last, const std::complex<T>* current_frame, const T* psd,
+        const T* psd_noise_est, std::complex<T>* filtered_frame);
 };
 
+using NoiseEstimator = BasicNoiseEstimator<double>;
+using WienerFilter = BasicWienerFilter<double>;
+
+// Scales the frame_size/2 + 1 bins of an R2C spectrum by 1/frame_size and writes their PSD |X|²
+template <typename T>
+void scaleSpectrum(std::complex<T>* spectrum, T* psd, size_t frame_size);
+
+// Overlap-add of one IFFT frame into acc, which holds the frame_size partial sums of the previous frames
+// (ignored for the first frame). The first hop samples are then complete: they are written to
+// out[0], out[stride], ... and acc slides by one hop.
+template <typename T>
+void overlapAdd(const T* recon, T* acc, size_t frame_size, size_t hop, bool first_frame,
+                T* out, size_t stride = 1);
+
+// Loop bodies shared by the runtime chain above and FixedDenoiseEngine. Each size argument is either a
+// size_t or a StaticSize<N>: the latter makes the loop bounds compile-time constants in the caller.
+namespace dsp_kernel {
+
+template <size_t N>
+using StaticSize = std::integral_constant<size_t, N>;
+
+// Minimum statistics update of bins [first, last) on row pos of a history ring of d rows, see
+// BasicNoiseEstimator. At the end of a block (pos == d - 1) the rows become suffix minima.
+template <typename T, typename Last, typename Stride, typename Depth>
+inline void minStatsUpdate(const T* current_power_spectrum, T* psd_smoothed, T* psd_noise_est,
+                           T* psd_history_buffer, T* prefix, size_t pos, size_t first, Last last,
+                           Stride stride, Depth d, T bias_comp) {
+    T alpha = T(0.8); // α - smoothing factor
+    T* row = &psd_history_buffer[pos * stride];
+    // Suffix minima of the previous block still in the window, none left at the end of a block
+    const T* suffix = (pos + 1 < d) ? row + stride : prefix;
+    const bool block_start = (pos == 0);
+
+    for (size_t i = first; i < last; i++){
+        // Smoothe the PSD in the current bin
+        // P_noise_smoothed[i] = α * P_noise_smoothed[i] + (1-α) * P_min[i] -> Leaky Integrator
+        psd_smoothed[i] = (alpha * psd_smoothed[i]) + ((1 - alpha) * current_power_spectrum[i]);
+
+        // Copy the smoothed psd of the current frame into the buffer
+        row[i] = psd_smoothed[i];
+        prefix[i] = (block_start || row[i] < prefix[i]) ? row[i] : prefix[i];
+
+        // Find the minimum power value in the bin across the d frames
+        T min_psd = (suffix[i] < prefix[i]) ? suffix[i] : prefix[i];
+
+        // Apply the bias compensation factor
+        psd_noise_est[i] = bias_comp * min_psd;
+    }
+
+    if (pos + 1 < d){
+        return;
+    }
+    // End of block: turn its rows into suffix minima, one contiguous row at a time
+    for (size_t j = d - 1; j-- > 0;){
+        T* cur = &psd_history_buffer[j * stride];
+        const T* next = cur + stride;
+        for (size_t i = first; i < last; i++){
+            cur[i] = (next[i] < cur[i]) ? next[i] : cur[i];
+        }
+    }
+}
+
+template <typename T, typename FrameSize>
+inline void scaleSpectrum(std::complex<T>* spectrum, T* psd, FrameSize frame_size){
+    const size_t fft_size = (frame_size / 2) + 1;
+    // Scale the results for posterior processing
+    T scale = T(1) / frame_size;
+    for (size_t k = 1; k < frame_size/2; ++k) {
+        spectrum[k] *= scale;
+    }
+    spectrum[0] *= T(1) * scale;
+    spectrum[fft_size - 1] *= T(1) * scale;
+
+    // Calculate the PSD from the current frame
+    for (size_t k = 0; k < fft_size; ++k) {
+        psd[k] = std::norm(spectrum[k]);
+    }
+}
+
+template <typename T, typename FrameSize, typename Hop>
+inline void overlapAdd(const T* recon, T* acc, FrameSize frame_size, Hop hop, bool first_frame,
+                       T* out, size_t stride = 1){
+    // The first frame_size - hop samples overlap the previous frames, the last hop samples start fresh
+    const size_t overlap_len = first_frame ? 0 : frame_size - hop;
+    for (size_t i = 0; i < overlap_len; i++){
+        acc[i] = recon[i] + acc[i];
+    }
+    for (size_t i = overlap_len; i < frame_size; i++){
+        acc[i] = recon[i];
+    }
+
+    // The first hop samples received every contribution, slide the accumulator by one hop
+    for (size_t i = 0; i < hop; i++){
+        out[i * stride] = acc[i];
+    }
+    std::copy(acc + hop, acc + frame_size, acc);
+}
+
+} // namespace dsp_kernel
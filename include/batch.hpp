@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "run_config.hpp"
+
+// Input files of a batch: the non-empty, non-comment (#) lines of a manifest file,
+// or the .wav/.pcm/.raw/.txt files of a directory in name order
+std::vector<std::string> listBatchInputs(const std::string& path);
+
+struct BatchReport {
+    size_t files = 0;
+    size_t failed = 0;
+    size_t frames = 0;
+    double seconds = 0.0;                           // Wall time of the whole batch
+};
+
+// Denoises every input as an independent job on a pool of config.jobs threads, each with its own
+// DenoiseEngine. The outputs of a file go to config.output_dir/<file stem>. A failing file is
+// reported and counted, the other jobs keep running.
+BatchReport runBatch(const RunConfig& config, const std::vector<std::string>& inputs,
+                     const std::vector<float>& window, size_t hop, size_t d);
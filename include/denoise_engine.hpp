@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <complex>
+#include <functional>
+#include <memory>
+#include "frame.hpp"
+#include "fft_engine.hpp"
+#include "audio_processing.hpp"
+#include "fixed_point.hpp"
+#include "thread_pool.hpp"
+
+// Complete denoising chain of one stream: windowing, FFT, noise estimation, Wiener filtering, IFFT and
+// overlap-add. The engine owns all per-stream state, so independent streams only need independent engines.
+// A stream may carry several interleaved channels. Their per-bin state is stored channel-major
+// ([channel][bin]) in single arrays, so the estimator and the filter update every channel in one pass.
+// T is the precision of the chain: DenoiseEngine runs in double, FloatDenoiseEngine in float, with twice
+// the SIMD lanes and half the memory traffic per bin.
+template <typename T>
+class BasicDenoiseEngine {
+    private:
+        size_t frame_size;                          // N
+        size_t hop;
+        size_t fft_size;                            // Bins per channel
+        size_t channels;
+        size_t d;                                   // Minimum statistics window in frames
+        double sample_rate = 48000.0;               // Only used to label frequency bins
+        BasicFrame<T> frame;
+        BasicFFTEngine<T> fft;
+        BasicNoiseEstimator<T> noise_est;
+        BasicWienerFilter<T> filter;
+        std::unique_ptr<FixedPointStage<T>> fixed_stage;    // Replaces noise_est and filter once set
+
+        std::vector<T> windowed_frame;              // Windowed samples of the last frame, [channel][sample]
+        std::vector<std::complex<T>> res;           // Scaled FFT of the last frame, [channel][bin]
+        std::vector<T> psd;                         // PSD of the last frame, [channel][bin]
+        std::vector<std::complex<T>> filtered_frame;
+        std::vector<T> recon_frame;                 // Last frame after the IFFT, [channel][sample]
+        std::vector<T> overlap;                     // Overlap-add accumulators, the first hop samples are complete
+        size_t frame_counter;
+
+        // Buffers of processFrames(), frame after frame, each laid out like the single-frame ones
+        std::vector<T> block_frames;
+        std::vector<std::complex<T>> block_spectra;
+        std::vector<T> block_psd;
+        std::vector<T> block_noise;
+        std::vector<std::complex<T>> block_filtered;
+        std::vector<T> block_recon;
+        ThreadPool* pool = nullptr;                 // Runs the per-frame phases of processFrames(), not owned
+        std::vector<std::unique_ptr<BasicFFTEngine<T>>> worker_ffts;    // One FFT work area per pool thread
+        bool fixed_fft = false;                     // fft and worker_ffts run the fixed-point FFT of fixed_fft_config
+        FixedFFTConfig fixed_fft_config;
+        bool split_bins = false;                    // Splits the noise estimation and filtering of a frame across pool
+        static constexpr size_t kMinBinsPerTask = 1024;         // Below this a task costs more than it saves
+
+        // Buffering of process(), interleaved like the input
+        std::vector<float> input;                   // Samples of the frame being filled
+        size_t filled;
+        std::vector<T> output;                      // Reconstructed samples not returned yet
+        size_t output_head;
+        size_t output_count;
+
+        // Buffering and timing of processBlock(), allocated by the constructor
+        std::vector<T> block_out;                   // Hop samples per channel completed by the last block
+        double worst_block_seconds = 0.0;
+        size_t realtime_blocks = 0;
+        size_t overrun_blocks = 0;
+
+        // Scaling and PSD of all channels of one frame
+        void analyzeSpectrum(std::complex<T>* spectrum, T* frame_psd) const;
+        // Noise estimation and Wiener filter of all channels of one frame, the only recursive stages
+        // In fixed point, frame_psd is replaced by the PSD of the quantized spectrum
+        void filterSpectrum(std::complex<T>* spectrum, T* frame_psd, std::complex<T>* filtered);
+        // Overlap-adds the IFFT of one frame and writes the hop interleaved samples it completes
+        void overlapAdd(const T* recon_channels, T* out);
+        // Overlap-add of channel c at sample p of the current block (0 is the start of its first frame),
+        // summing the carried partial sums and the first count frames in the order overlapAdd() does
+        T overlapSum(size_t p, size_t c, size_t count) const;
+        // Runs task(first, last, fft) over contiguous ranges of [0, count), one per pool thread
+        void parallelFor(size_t count, const std::function<void(size_t, size_t, BasicFFTEngine<T>&)>& task);
+
+    public:
+        using sample_type = T;
+
+        // window holds the N analysis window coefficients, hop is N for no overlap or N/2 for 50% overlap,
+        // d is the length of the minimum statistics window in frames
+        BasicDenoiseEngine(const std::vector<float>& window, size_t hop, size_t d = 64, size_t channels = 1);
+
+        // Streaming interface: consumes n samples per channel and writes n samples per channel, both
+        // interleaved. The output is the denoised input delayed by latency() samples. in and out may be
+        // the same buffer.
+        void process(const float* in, size_t n, float* out);
+        size_t latency() const { return frame_size - 1; }
+
+        // Real-time interface for audio callbacks: consumes exactly hop samples per channel and writes hop
+        // samples per channel, both interleaved. Once initialized, it never allocates, locks nor does I/O,
+        // so keep setBinSplit() off here. The output is the denoised input delayed by
+        // blockLatency() = frame_size - hop samples, zeros until the first frame is complete. Each call is
+        // timed: see worstBlockTime() and overruns(). Do not mix with process() on the same engine.
+        void processBlock(const float* in, float* out, size_t hop);
+        size_t blockLatency() const { return frame_size - hop; }
+        // Longest processBlock() call so far, in seconds, and the number of calls that took longer than the
+        // duration of a hop at sampleRate()
+        double worstBlockTime() const { return worst_block_seconds; }
+        size_t overruns() const { return overrun_blocks; }
+        size_t blockCount() const { return realtime_blocks; }
+        void resetBlockTiming() { worst_block_seconds = 0.0; realtime_blocks = 0; overrun_blocks = 0; }
+
+        // Frame interface: processes the frame_size interleaved samples per channel starting at samples and
+        // writes the hop interleaved samples per channel it completes into out
+        void processFrame(const float* samples, T* out);
+
+        // Block interface for offline runs: processes count consecutive frames, frame j starting j hops
+        // after samples, and writes the count * hop interleaved samples per channel they complete into out.
+        // Windowing and the FFT/IFFT run batched over the whole block, the recursive noise estimation
+        // and filtering frame after frame. Results are identical to count processFrame calls.
+        void processFrames(const float* samples, size_t count, T* out);
+
+        // Splits processFrames() in three phases for multi-core offline runs: the analysis (windowing, FFT,
+        // PSD) of all frames of the block runs in parallel on pool, the recursive noise estimation and
+        // filtering then go frame after frame on the calling thread, and the synthesis (IFFT, overlap-add)
+        // runs in parallel again. nullptr runs every phase on the calling thread.
+        void setThreadPool(ThreadPool* pool);
+
+        // Splits the bins of the noise estimation and Wiener filtering of every frame across the pool
+        // attached with setThreadPool(), in chunks of whole cache lines. It lowers the per-frame latency of
+        // large frames (4096 or 8192 points); frames with fewer than 2 * kMinBinsPerTask bins stay on one thread.
+        void setBinSplit(bool enable) { split_bins = enable; }
+
+        // Runs the noise estimation and Wiener filter bit-true in the fixed-point formats of config, for
+        // every later frame: the scaled spectrum is quantized to config.data, and the filtered spectrum
+        // comes back to T for the IFFT. Set it before the first frame; bin splitting does not apply.
+        // Throws std::invalid_argument for an unsupported config.
+        void setFixedPoint(const FixedPointConfig& config);
+        bool fixedPoint() const { return fixed_stage != nullptr; }
+
+        // Runs the FFT and IFFT of every later frame bit-accurately in the block-floating-point words of
+        // config instead of pocketfft, on the calling thread and on the pool. Throws std::invalid_argument
+        // for an unsupported config or a frame size that is not a power of two.
+        void setFixedFFT(const FixedFFTConfig& config);
+        bool fixedFFT() const { return fixed_fft; }
+
+        void setSampleRate(double rate) { sample_rate = rate; }
+        double sampleRate() const { return sample_rate; }
+        size_t frameSize() const { return frame_size; }
+        size_t hopSize() const { return hop; }
+        size_t binCount() const { return fft_size; }
+        size_t channelCount() const { return channels; }
+        size_t frameCount() const { return frame_counter; }
+
+        // Intermediate results of the last processed frame, channel after channel
+        const std::vector<T>& windowedFrame() const { return windowed_frame; }
+        const std::vector<std::complex<T>>& spectrum() const { return res; }
+        const std::vector<T>& signalPSD() const { return psd; }
+        const std::vector<T>& noisePSD() const { return fixed_stage ? fixed_stage->getNoiseEstimate() : noise_est.getNoiseEstimate(); }
+
+        // Intermediate results of frame j of the last block, channel after channel
+        const T* blockFrame(size_t j) const { return &block_frames[j * channels * frame_size]; }
+        const std::complex<T>* blockSpectrum(size_t j) const { return &block_spectra[j * channels * fft_size]; }
+        const T* blockSignalPSD(size_t j) const { return &block_psd[j * channels * fft_size]; }
+        const T* blockNoisePSD(size_t j) const { return &block_noise[j * channels * fft_size]; }
+};
+
+using DenoiseEngine = BasicDenoiseEngine<double>;
+using FloatDenoiseEngine = BasicDenoiseEngine<float>;
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "denoise_engine.hpp"
+#include "spsc_ring.hpp"
+
+// Dedicated DSP thread between a capture thread and a playback (or network) thread. It consumes
+// hop-sized blocks from the input ring, runs DenoiseEngine::processBlock on them and publishes each
+// output block to the output ring. The rings are the only link between the threads: the capture thread
+// is the only writer of input and the playback thread the only reader of output.
+// When output is full the worker waits for the reader instead of dropping blocks.
+class DspWorker {
+    private:
+        DenoiseEngine& engine;
+        SpscRing<float>& input;
+        SpscRing<float>& output;
+        std::vector<float> in_block;                // Hop samples per channel, interleaved
+        std::vector<float> out_block;
+        std::thread thread;
+        std::atomic<bool> draining{false};          // Leave once no complete block is queued
+        std::atomic<bool> stopping{false};          // Leave now
+        std::atomic<bool> done{false};
+        std::atomic<size_t> blocks{0};
+
+        void run();
+    public:
+        DspWorker(DenoiseEngine& engine, SpscRing<float>& input, SpscRing<float>& output);
+        ~DspWorker();
+        DspWorker(const DspWorker&) = delete;
+        DspWorker& operator=(const DspWorker&) = delete;
+
+        void start();
+        // Lets the worker process the complete blocks still queued and leave, without waiting for it. It is
+        // sticky: a worker finished before start() drains its input and leaves too.
+        void finish() { draining.store(true, std::memory_order_release); }
+        // True once the thread left its loop
+        bool finished() const { return done.load(std::memory_order_acquire); }
+        // Stops the worker at the next block boundary and joins it
+        void stop();
+        size_t blockCount() const { return blocks.load(std::memory_order_relaxed); }
+};
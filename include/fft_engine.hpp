@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <complex>
+#include <memory>
+#include <pocketfft_hdronly.h>
+#include "fixed_fft.hpp"
+
+// Real FFT of a fixed frame size in precision T (double or float). The pocketfft plan and the aligned
+// work buffers are built once, so forward/inverse calls do not re-plan or allocate.
+template <typename T>
+class BasicFFTEngine {
+    private:
+        size_t frame_size;
+        pocketfft::detail::pocketfft_r<T> plan;
+        pocketfft::detail::arr<T> buffer;           // Halfcomplex (FFTPACK order) work buffer
+        pocketfft::detail::arr<T> scratch;          // Scratch used by the plan
+#ifndef POCKETFFT_NO_VECTORS
+        // Batched transforms run the same plan on SIMD vectors, one frame per lane
+        using vtype = pocketfft::detail::vtype_t<T>;
+        static constexpr size_t vlen = pocketfft::detail::VLEN<T>::val;
+        pocketfft::detail::arr<vtype> vbuffer;
+        pocketfft::detail::arr<vtype> vscratch;
+#endif
+        // Bit-accurate fixed-point transforms replacing pocketfft once set, one of the two
+        std::unique_ptr<FixedPointFFT16> fixed16;
+        std::unique_ptr<FixedPointFFT32> fixed32;
+
+        void unpack(std::complex<T>* out) const;        // buffer (halfcomplex) -> frame_size/2 + 1 bins
+        void pack(const std::complex<T>* in);           // frame_size/2 + 1 bins -> buffer (halfcomplex)
+    public:
+        explicit BasicFFTEngine(size_t frame_size_param);
+        // Runs every transform through the fixed-point FFT of config instead of pocketfft. Throws
+        // std::invalid_argument when the config or the frame size is not supported.
+        void setFixedPoint(const FixedFFTConfig& config);
+        bool fixedPoint() const { return fixed16 != nullptr || fixed32 != nullptr; }
+        // R2C DFT (no scaling), out must hold frame_size/2 + 1 bins
+        void forward(const T* in, std::complex<T>* out);
+        // C2R DFT (no scaling), in must hold frame_size/2 + 1 bins
+        void inverse(const std::complex<T>* in, T* out);
+        // count transforms at once: in/out hold count contiguous frames of frame_size samples or
+        // frame_size/2 + 1 bins. Results are identical to count single calls.
+        void forward(const T* in, std::complex<T>* out, size_t count);
+        void inverse(const std::complex<T>* in, T* out, size_t count);
+        size_t size() const { return frame_size; }
+        size_t bins() const { return (frame_size / 2) + 1; }
+};
+
+using FFTEngine = BasicFFTEngine<double>;
@@ -3,9 +3,16 @@
 #include <string>
 #include <complex>
 #include <cstdint>
+#include <fstream>
+#include <memory>
 
+// Legacy text input: one 16-character line of ASCII '0'/'1' bits per Q15 sample
 std::vector<float> readBinData(const std::string& filename);
 std::vector<float> readHexData(const std::string& filename);
+// Raw little-endian int16 (Q15) samples without header
+std::vector<float> readPcm16Data(const std::string& filename);
+// PCM WAV file, 16-bit integer or 32-bit float samples, interleaved when it has several channels
+std::vector<float> readWavData(const std::string& filename);
 
 // Saves a 2D vector of doubles to a .txt file with a metadata header
 void writeFrames(const std::vector<std::vector<double>>& frames, const std::string& filename);
@@ -19,3 +26,208 @@ void WriteSignal(const std::vector<double> &signal);
 std::vector<std::vector<double>> readFrames(const std::string& filename);
 
 void testReadWrite();
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+    private:
+        const unsigned char* bytes;
+        size_t length;
+#ifdef _WIN32
+        void* handle;
+        void* mapping;
+#endif
+    public:
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        const unsigned char* data() const { return bytes; }
+        size_t size() const { return length; }
+};
+
+// Pulls samples from an input file in chunks, so the whole signal never has to be held in memory
+class SampleSource {
+    public:
+        virtual ~SampleSource() = default;
+        // Reads up to count samples into dst, returns the number of samples read (0 at end of input).
+        // Samples of multi-channel inputs are interleaved.
+        virtual size_t read(float* dst, size_t count) = 0;
+        virtual size_t channels() const { return 1; }
+        // Sample rate stored in the input, 0 when the format does not carry one
+        virtual uint32_t sampleRate() const { return 0; }
+};
+
+// Reads the ASCII '0'/'1' Q15 line format of readBinData incrementally
+class BinTextSource : public SampleSource {
+    private:
+        std::ifstream file;
+        std::string line;
+    public:
+        explicit BinTextSource(const std::string& filename);
+        size_t read(float* dst, size_t count) override;
+};
+
+// Reads the raw little-endian int16 (Q15) format from a memory-mapped file, interleaved for several channels
+class Pcm16Source : public SampleSource {
+    private:
+        MappedFile file;
+        size_t offset;
+        size_t numChannels;
+    public:
+        explicit Pcm16Source(const std::string& filename, size_t numChannels = 1);
+        size_t read(float* dst, size_t count) override;
+        size_t channels() const override { return numChannels; }
+};
+
+// Reads the interleaved samples of a PCM WAV file (16-bit integer or 32-bit float) from a memory-mapped file
+class WavSource : public SampleSource {
+    private:
+        MappedFile file;
+        const unsigned char* samples;
+        size_t numSamples;
+        size_t offset;
+        uint16_t format;                            // 1: PCM integer, 3: IEEE float
+        uint16_t bitsPerSample;
+        uint16_t numChannels;
+        uint32_t rate;
+    public:
+        explicit WavSource(const std::string& filename);
+        size_t read(float* dst, size_t count) override;
+        size_t channels() const override { return numChannels; }
+        uint32_t sampleRate() const override { return rate; }
+};
+
+// Picks the reader from the file extension: .wav, .pcm/.raw for raw int16, anything else is the text format.
+// channels only applies to raw int16 files, WAV files carry their own channel count.
+std::unique_ptr<SampleSource> openSampleSource(const std::string& filename, size_t channels = 1);
+
+// Format of the frame, FFT, PSD and signal dumps
+enum class OutputFormat { Text, Binary };
+
+// Destination of a stream of real frames, count is always a whole number of frames
+class FrameSink {
+    public:
+        virtual ~FrameSink() = default;
+        virtual void write(const double* data, size_t count) = 0;
+        void write(const std::vector<double>& frame) { write(frame.data(), frame.size()); }
+        virtual void close() = 0;
+};
+
+// Destination of a stream of complex frames, count is always a whole number of frames
+class SpectrumSink {
+    public:
+        virtual ~SpectrumSink() = default;
+        virtual void write(const std::complex<double>* data, size_t count) = 0;
+        void write(const std::vector<std::complex<double>>& frame) { write(frame.data(), frame.size()); }
+        virtual void close() = 0;
+};
+
+// Appends frames of doubles to a .txt file as they are produced, same format as writeFrames.
+// The numFrames field of the header is patched when the writer is closed.
+class FrameWriter : public FrameSink {
+    private:
+        std::ofstream file;
+        std::string filename;
+        size_t frameSize;
+        size_t numFrames;
+        std::streampos countPos;
+    public:
+        FrameWriter(const std::string& filename, size_t frameSize);
+        ~FrameWriter();
+        using FrameSink::write;
+        void write(const double* data, size_t count) override;
+        void close() override;
+};
+
+// Appends frames of complex doubles to a .txt file as they are produced, same format as writeFFT
+class FFTWriter : public SpectrumSink {
+    private:
+        std::ofstream file;
+        std::string filename;
+        size_t frameSize;
+        size_t numFrames;
+        std::streampos countPos;
+    public:
+        FFTWriter(const std::string& filename, size_t frameSize);
+        ~FFTWriter();
+        using SpectrumSink::write;
+        void write(const std::complex<double>* data, size_t count) override;
+        void close() override;
+};
+
+// Appends samples of the reconstructed signal to a .txt file, same format as WriteSignal (interleaved for
+// several channels)
+class SignalWriter : public FrameSink {
+    private:
+        std::ofstream file;
+        size_t numSamples;
+    public:
+        explicit SignalWriter(const std::string& filename);
+        using FrameSink::write;
+        void write(const double* samples, size_t count) override;
+        void close() override;
+};
+
+// Binary frame container, readable with np.memmap(path, dtype, offset=32, shape=(numFrames, frameSize)):
+//   offset  0  char[8]  magic "AFSFRAME"
+//   offset  8  uint32   version (1)
+//   offset 12  uint32   dtype, see BinaryFrameType
+//   offset 16  uint64   frameSize
+//   offset 24  uint64   numFrames
+//   offset 32  numFrames * frameSize little-endian elements, frame after frame
+// A signal is stored with frameSize = number of channels, one frame per sample instant.
+enum class BinaryFrameType : uint32_t { Float64 = 1, Complex128 = 2 };
+constexpr size_t kBinaryHeaderSize = 32;
+
+// Appends frames of doubles to a binary frame container, numFrames is patched on close
+class BinaryFrameWriter : public FrameSink {
+    private:
+        std::ofstream file;
+        std::string filename;
+        size_t frameSize;
+        size_t numFrames;
+    public:
+        BinaryFrameWriter(const std::string& filename, size_t frameSize);
+        ~BinaryFrameWriter();
+        using FrameSink::write;
+        void write(const double* data, size_t count) override;
+        void close() override;
+};
+
+// Appends frames of complex doubles to a binary frame container, numFrames is patched on close
+class BinaryFFTWriter : public SpectrumSink {
+    private:
+        std::ofstream file;
+        std::string filename;
+        size_t frameSize;
+        size_t numFrames;
+    public:
+        BinaryFFTWriter(const std::string& filename, size_t frameSize);
+        ~BinaryFFTWriter();
+        using SpectrumSink::write;
+        void write(const std::complex<double>* data, size_t count) override;
+        void close() override;
+};
+
+// Zero-copy reader of a binary frame container, frames point straight into the mapped file
+class BinaryFrameView {
+    private:
+        MappedFile file;
+        BinaryFrameType dtype;
+        size_t frameSize;
+        size_t numFrames;
+    public:
+        explicit BinaryFrameView(const std::string& filename);
+        BinaryFrameType type() const { return dtype; }
+        size_t size() const { return numFrames; }
+        size_t frameLength() const { return frameSize; }
+        // Frame i of a Float64 container, throws std::out_of_range when i >= size()
+        const double* frame(size_t i) const;
+        // Frame i of a Complex128 container, throws std::out_of_range when i >= size()
+        const std::complex<double>* spectrum(size_t i) const;
+};
+
+// Writer for the given format, file extensions are left to the caller
+std::unique_ptr<FrameSink> openFrameSink(const std::string& filename, size_t frameSize, OutputFormat format);
+std::unique_ptr<SpectrumSink> openSpectrumSink(const std::string& filename, size_t frameSize, OutputFormat format);
+std::unique_ptr<FrameSink> openSignalSink(const std::string& filename, OutputFormat format, size_t channels = 1);
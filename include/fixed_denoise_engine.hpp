@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "audio_processing.hpp"
+#include "fft_engine.hpp"
+#include "stage_timer.hpp"
+#include "wiener_kernel.hpp"
+
+// Compile-time window tables
+namespace fixed_window {
+
+// Cosine usable in constant expressions (std::cos is not constexpr in C++17), accurate to a few ULP
+constexpr double cosine(double x) {
+    constexpr double pi = 3.14159265358979323846;
+    // Reduce to [-pi, pi], where the Taylor series converges quickly
+    while (x > pi) x -= 2.0 * pi;
+    while (x < -pi) x += 2.0 * pi;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 30; k++) {
+        term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Periodic Hann window of N points, COLA-normalized for Hop like makeWindow()
+template <size_t N, size_t Hop>
+constexpr std::array<float, N> hann() {
+    constexpr double pi = 3.14159265358979323846;
+    std::array<float, N> window{};
+    double sum = 0.0;
+    for (size_t n = 0; n < N; n++) {
+        window[n] = static_cast<float>(0.5 - 0.5 * cosine(2.0 * pi * static_cast<double>(n) / static_cast<double>(N)));
+        sum += window[n];
+    }
+    const double gain = static_cast<double>(Hop) / sum;
+    for (size_t n = 0; n < N; n++) {
+        window[n] = static_cast<float>(window[n] * gain);
+    }
+    return window;
+}
+
+} // namespace fixed_window
+
+// DenoiseEngine specialized at compile time for one mono frame size N, hop and minimum statistics
+// window D. Every buffer is a fixed-size std::array and the noise estimator, spectrum scaling and
+// overlap-add run the dsp_kernel loops shared with DenoiseEngine with constant sizes, so the compiler
+// can fully unroll and vectorize them while both engines produce identical outputs. The Wiener gain
+// keeps the runtime-dispatched SIMD kernel. Sizes not instantiated here use the runtime DenoiseEngine.
+template <size_t N, size_t Hop, size_t D = 64>
+class FixedDenoiseEngine {
+    static_assert(N >= 4 && N % 2 == 0, "Frame size must be even");
+    static_assert(Hop > 0 && Hop <= N && N % Hop == 0, "Hop must divide the frame size");
+    static_assert(D > 0, "Minimum statistics window needs at least one frame");
+
+    public:
+        using sample_type = double;
+        static constexpr size_t kBins = (N / 2) + 1;
+
+    private:
+        static constexpr size_t kStride = paddedCount<double>(kBins);   // History rows start on a cache line
+        static constexpr double kBias = 1.2;                            // Minimum statistics bias compensation
+
+        std::array<float, N> window;
+        FFTEngine fft;
+        WienerGainKernel kernel;
+
+        alignas(kCacheLine) std::array<double, N> windowed_frame{};
+        alignas(kCacheLine) std::array<std::complex<double>, kBins> res{};
+        alignas(kCacheLine) std::array<double, kBins> psd{};
+        alignas(kCacheLine) std::array<std::complex<double>, kBins> filtered_frame{};
+        alignas(kCacheLine) std::array<double, N> recon_frame{};
+        alignas(kCacheLine) std::array<double, N> overlap{};
+        size_t frame_counter = 0;
+
+        // Noise estimator state, see NoiseEstimator
+        alignas(kCacheLine) std::array<double, kBins> psd_smoothed{};
+        alignas(kCacheLine) std::array<double, kBins> psd_noise_est{};
+        alignas(kCacheLine) std::array<double, D * kStride> psd_history_buffer{};
+        alignas(kCacheLine) std::array<double, kStride> psd_prefix_min{};
+        size_t pos = 0;
+
+        // Wiener filter state, see WienerFilter
+        alignas(kCacheLine) std::array<double, kBins> p_xi{};
+        alignas(kCacheLine) std::array<double, kBins> p_SNR{};
+
+        void estimateNoise() {
+            dsp_kernel::minStatsUpdate(psd.data(), psd_smoothed.data(), psd_noise_est.data(),
+                                       psd_history_buffer.data(), psd_prefix_min.data(), pos, 0,
+                                       dsp_kernel::StaticSize<kBins>(), dsp_kernel::StaticSize<kStride>(),
+                                       dsp_kernel::StaticSize<D>(), kBias);
+            pos = (pos + 1 < D) ? pos + 1 : 0;
+        }
+
+    public:
+        // Hann window built at compile time
+        static constexpr std::array<float, N> kHann = fixed_window::hann<N, Hop>();
+
+        // Uses the compile-time Hann table, or the given window of N coefficients
+        explicit FixedDenoiseEngine(SimdLevel simd = detectSimdLevel())
+            : FixedDenoiseEngine(kHann, simd) {}
+        explicit FixedDenoiseEngine(const std::array<float, N>& window_param, SimdLevel simd = detectSimdLevel())
+            : window(window_param), fft(N), kernel(wienerGainKernel(simd)) {
+            psd_noise_est.fill(1e-10);
+            psd_history_buffer.fill(1.0);
+            psd_prefix_min.fill(1.0);
+            p_SNR.fill(1e-10);
+        }
+        explicit FixedDenoiseEngine(const std::vector<float>& window_param, SimdLevel simd = detectSimdLevel())
+            : FixedDenoiseEngine(toArray(window_param), simd) {}
+
+        static std::array<float, N> toArray(const std::vector<float>& coeffs) {
+            if (coeffs.size() != N) {
+                throw std::invalid_argument("Window size does not match the engine frame size");
+            }
+            std::array<float, N> result;
+            std::copy(coeffs.begin(), coeffs.end(), result.begin());
+            return result;
+        }
+
+        // Same contract as DenoiseEngine::processFrame for one channel
+        void processFrame(const float* samples, double* out) {
+            // 1. Windowing
+            {
+                StageTimer timer(Stage::Window);
+                for (size_t i = 0; i < N; i++) {
+                    windowed_frame[i] = static_cast<float>(samples[i]) * window[i];
+                }
+            }
+
+            // 2. FFT, scaling and PSD
+            {
+                StageTimer timer(Stage::FFT);
+                fft.forward(windowed_frame.data(), res.data());
+            }
+            {
+                StageTimer timer(Stage::PSD);
+                dsp_kernel::scaleSpectrum(res.data(), psd.data(), dsp_kernel::StaticSize<N>());
+            }
+
+            // 3. Noise estimation, 4. Wiener filter
+            {
+                StageTimer timer(Stage::Noise);
+                estimateNoise();
+            }
+            {
+                StageTimer timer(Stage::Wiener);
+                kernel(kBins, res.data(), psd.data(), psd_noise_est.data(), p_xi.data(), p_SNR.data(),
+                       filtered_frame.data(), 0.35, 0.15);
+            }
+
+            // 5. IFFT, 6. overlap-add
+            {
+                StageTimer timer(Stage::IFFT);
+                fft.inverse(filtered_frame.data(), recon_frame.data());
+            }
+            StageTimer timer(Stage::OLA);
+            dsp_kernel::overlapAdd(recon_frame.data(), overlap.data(), dsp_kernel::StaticSize<N>(),
+                                   dsp_kernel::StaticSize<Hop>(), frame_counter == 0, out);
+            frame_counter++;
+        }
+
+        static constexpr size_t frameSize() { return N; }
+        static constexpr size_t hopSize() { return Hop; }
+        static constexpr size_t binCount() { return kBins; }
+        size_t frameCount() const { return frame_counter; }
+
+        // Intermediate results of the last processed frame
+        const std::array<double, N>& windowedFrame() const { return windowed_frame; }
+        const std::array<std::complex<double>, kBins>& spectrum() const { return res; }
+        const std::array<double, kBins>& signalPSD() const { return psd; }
+        const std::array<double, kBins>& noisePSD() const { return psd_noise_est; }
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include "aligned_allocator.hpp"
+#include "fixed_point.hpp"
+#include "wiener_kernel.hpp"
+
+// Word lengths of the fixed-point FFT. Mantissas are word_bits wide and share one exponent per block
+// (block floating point); twiddle factors are rounded to twiddle_bits, 1.0 saturating to 1 - 2^(1 - twiddle_bits).
+struct FixedFFTConfig {
+    unsigned word_bits = 16;            // 16 (int16_t words) or 32 (int32_t words)
+    unsigned twiddle_bits = 16;         // 2 to word_bits
+    FixedRounding rounding = FixedRounding::Trunc;  // Of the stage scaling and the twiddle products
+
+    // Throws std::invalid_argument for unsupported word lengths
+    void validate() const;
+};
+
+template <typename Word>
+struct FixedFFTKernels;
+
+// Bit-accurate radix-4/2 real FFT and IFFT of a power-of-two frame size in block floating point. The real
+// transform of N points runs as a complex Stockham FFT of N/2 points: radix-4 stages, a final twiddle-free
+// radix-2 stage when log2(N/2) is odd, then the split into the N/2 + 1 real bins (the inverse runs the same
+// stages backwards from the merged bins). Before each stage the block is shifted, left exactly or right with
+// rounding, so that its largest mantissa keeps the guard bits the stage needs (3 for radix-4 and the split,
+// 1 for radix-2) and no butterfly can overflow; the shift goes into the block exponent. Butterfly sums are
+// exact and every twiddle product is rounded once to the word. Word is int16_t or int32_t.
+template <typename Word>
+class BasicFixedPointFFT {
+    private:
+        size_t frame_size;                          // N
+        size_t half;                                // M = N/2, the length of the complex FFT
+        FixedFFTConfig config;
+        aligned_vector<Word> twiddles;              // Radix-4 stages one after the other, 6 rows of n/4 each
+        aligned_vector<Word> re, im;                // Ping-pong buffers of the complex FFT, M words each
+        aligned_vector<Word> re_tmp, im_tmp;
+        aligned_vector<Word> split_twiddles;        // W^k for k <= M, real and imaginary interleaved
+        aligned_vector<Word> samples;               // Quantized frame of the T interface
+        aligned_vector<Word> spectrum;              // Quantized bins of the T interface
+        aligned_vector<Word> planar;                // Bins of inverse(), real parts then imaginary ones
+        const FixedFFTKernels<Word>* kernels;
+
+        // Runs the stages of the complex FFT on re/im at block exponent exponent and leaves the result there.
+        // bits is the OR of the input magnitudes on entry and of the output ones on return. Returns the
+        // exponent of the result.
+        int complexFFT(Word& bits, int exponent);
+    public:
+        BasicFixedPointFFT(size_t frame_size, const FixedFFTConfig& config, SimdLevel simd = detectSimdLevel());
+
+        // Raw transforms on mantissas. forward() takes N samples in * 2^-(word_bits - 1) and writes N/2 + 1
+        // bins, real and imaginary parts interleaved, worth out * 2^exponent with the returned exponent.
+        // inverse() takes bins worth in * 2^exponent, ignores the imaginary parts of DC and Nyquist as
+        // pocketfft does, and writes N samples worth out * 2^returned exponent. Neither scales by 1/N.
+        int forward(const Word* in, Word* out);
+        int inverse(const Word* in, int exponent, Word* out);
+
+        // Drop-in transforms of FFTEngine: the input samples are rounded and saturated to the word, the input
+        // spectrum is quantized to word mantissas with one exponent, and the results are converted back to T
+        template <typename T>
+        void forward(const T* in, std::complex<T>* out);
+        template <typename T>
+        void inverse(const std::complex<T>* in, T* out);
+
+        size_t size() const { return frame_size; }
+        size_t bins() const { return half + 1; }
+};
+
+using FixedPointFFT16 = BasicFixedPointFFT<int16_t>;
+using FixedPointFFT32 = BasicFixedPointFFT<int32_t>;
@@ -0,0 +1,119 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "wiener_kernel.hpp"
+
+// Rounding and overflow modes of FixedPointValue in python/quant_tool.py. Trunc rounds towards minus
+// infinity (math.floor), Round uses Python's round(), which rounds half to even, so it matches RoundEven.
+enum class FixedRounding { Trunc, Round, RoundEven };
+enum class FixedOverflow { Saturate, Wrap };
+
+// Word format of a fixed-point quantity, S(total - frac, frac) or U(total - frac, frac) in the notation of
+// FixedPointValue. Values are held as raw integers value * 2^frac_bits in int32_t words.
+struct FixedPointFormat {
+    unsigned total_bits = 16;           // NB_total, 2 to 32 (31 when unsigned)
+    unsigned frac_bits = 15;            // NB_float, 0 to 31
+    bool is_signed = true;
+    FixedRounding rounding = FixedRounding::Trunc;
+    FixedOverflow overflow = FixedOverflow::Saturate;
+
+    int64_t minValue() const { return is_signed ? -(int64_t(1) << (total_bits - 1)) : 0; }
+    int64_t maxValue() const { return is_signed ? (int64_t(1) << (total_bits - 1)) - 1 : (int64_t(1) << total_bits) - 1; }
+    // Raw value of FixedPointValue(total_bits, frac_bits, value, is_signed, rounding, overflow)
+    int32_t quantize(double value) const;
+    double toDouble(int64_t raw) const;
+    // Throws std::invalid_argument when the format is outside the supported ranges
+    void validate(const char* name) const;
+};
+
+// Word formats of the fixed-point noise estimator and Wiener filter. Every operation is carried out
+// exactly on integers and its result rounded and saturated (or wrapped) into the format of its
+// destination, as FixedPointValue would on the exact value.
+struct FixedPointConfig {
+    FixedPointFormat data;              // Real and imaginary parts of the spectrum, before and after filtering
+    FixedPointFormat power;             // PSD, smoothed PSD, its minima and the noise estimate
+    FixedPointFormat ratio;             // A posteriori SNR |X|²/|Ŵ|² and the decision-directed ξ
+    FixedPointFormat gain;              // Wiener gain ξ/(1+ξ)
+    FixedPointFormat coef;              // Smoothing factors and the bias compensation of the estimator
+
+    // 16-bit data, gain and coefficient words, 32-bit power and ratio accumulators
+    static FixedPointConfig q15();
+    // 32-bit words throughout
+    static FixedPointConfig q31();
+    void setRounding(FixedRounding rounding);
+    void setOverflow(FixedOverflow overflow);
+    // Throws std::invalid_argument when a format is out of range or the power format keeps more fraction
+    // bits than the square of the data format
+    void validate() const;
+};
+
+struct FixedPointKernels;
+
+// Minimum statistics noise estimator of NoiseEstimator in fixed point, over raw power-format PSDs
+class FixedPointNoiseEstimator {
+    private:
+        size_t num_bins;
+        size_t d;
+        size_t stride;                              // Row length, num_bins padded to a cache line
+        aligned_vector<int32_t> psd_smoothed;
+        aligned_vector<int32_t> psd_noise_est;
+        aligned_vector<int32_t> psd_history_buffer; // Same van Herk/Gil-Werman layout as NoiseEstimator
+        aligned_vector<int32_t> psd_prefix_min;
+        size_t pos;
+        FixedPointConfig config;
+        int32_t alpha, one_minus_alpha, bias;       // Coefficient-format constants
+        const FixedPointKernels* kernels;
+    public:
+        FixedPointNoiseEstimator(size_t num_bins, size_t d, const FixedPointConfig& config,
+                                 SimdLevel simd = detectSimdLevel());
+        void update(const int32_t* current_power_spectrum);
+        const int32_t* getNoiseEstimate() const { return psd_noise_est.data(); }
+        size_t binCount() const { return num_bins; }
+};
+
+// Decision-directed Wiener filter of WienerFilter in fixed point. Spectra are raw data-format words,
+// real and imaginary parts interleaved.
+class FixedPointWienerFilter {
+    private:
+        size_t num_bins;
+        aligned_vector<int32_t> p_xi;
+        aligned_vector<int32_t> p_SNR;
+        aligned_vector<int32_t> gain;               // Gains of the current frame
+        FixedPointConfig config;
+        int32_t alpha_w, one_minus_alpha_w, alpha_snr, one_minus_alpha_snr;    // Coefficient format
+        int32_t one, xi_floor;                                                  // Ratio format
+        const FixedPointKernels* kernels;
+    public:
+        FixedPointWienerFilter(size_t num_bins, const FixedPointConfig& config, SimdLevel simd = detectSimdLevel());
+        void apply(const int32_t* current_frame, const int32_t* psd, const int32_t* psd_noise_est,
+                   int32_t* filtered_frame);
+};
+
+// Fixed-point noise estimation and Wiener filtering of all channels of a frame, for DenoiseEngine. The
+// scaled spectrum of the floating-point chain is quantized to the data format on the way in, and the
+// fixed-point PSD, noise estimate and filtered spectrum are converted back to T on the way out.
+template <typename T>
+class FixedPointStage {
+    private:
+        size_t num_bins;
+        FixedPointConfig config;
+        FixedPointNoiseEstimator estimator;
+        FixedPointWienerFilter filter;
+        const FixedPointKernels* kernels;
+        aligned_vector<int32_t> spectrum;           // Quantized spectrum of the current frame
+        aligned_vector<int32_t> psd;
+        aligned_vector<int32_t> filtered;
+        std::vector<T> noise;                       // Noise estimate converted to T
+    public:
+        FixedPointStage(size_t num_bins, size_t d, const FixedPointConfig& config, SimdLevel simd = detectSimdLevel());
+        // Quantizes the spectrum, computes its PSD and updates the noise estimate. frame_psd receives the
+        // fixed-point PSD.
+        void estimateNoise(const std::complex<T>* current_frame, T* frame_psd);
+        // Filters the spectrum quantized by the last estimateNoise() into filtered_frame
+        void filterSpectrum(std::complex<T>* filtered_frame);
+        const std::vector<T>& getNoiseEstimate() const { return noise; }
+};
@@ -2,13 +2,22 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
-class Frame {
+// Windows frames of float samples into frames of T, double for the reference chain or float for the
+// single-precision one. The window product is computed in float in both cases.
+template <typename T>
+class BasicFrame {
 public:
-    Frame(size_t frameSize, const std::vector<float>& coeffs);
-    std::vector<double> generateFrame(const std::vector<float>& input, size_t startIndex);
+    BasicFrame(size_t frameSize, const std::vector<float>& coeffs);
+    std::vector<T> generateFrame(const std::vector<float>& input, size_t startIndex);
+    // Windows the frame starting at input into a caller-provided buffer of frameSize samples,
+    // reading every stride-th input sample (stride = channel count for interleaved input)
+    void generateFrame(const float* input, T* frame, size_t stride = 1) const;
 
 private:
     size_t size;
     std::vector<float> windowCoeffs;
 };
+
+using Frame = BasicFrame<double>;
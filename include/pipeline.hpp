@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "run_config.hpp"
+
+// Denoises config.input_file with a fresh DenoiseEngine and writes the taps requested by config into
+// config.output_dir. window holds the analysis window, hop the frame advance and d the length of the
+// minimum statistics window. Multi-channel inputs are denoised channel by channel in one engine and
+// their taps hold one frame per channel. Returns the number of frames processed.
+size_t denoiseFile(const RunConfig& config, const std::vector<float>& window, size_t hop, size_t d);
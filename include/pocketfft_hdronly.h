@@ -2388,9 +2388,17 @@ template<typename T> void radbg(size_t ido, size_t ip, size_t l1,
     template<typename T> void exec(T c[], T0 fct, bool r2hc) const
       {
       if (length==1) { c[0]*=fct; return; }
-      size_t nf=fact.size();
       arr<T> ch(length);
-      T *p1=c, *p2=ch.data();
+      exec(c, fct, r2hc, ch.data());
+      }
+
+    // Variant taking caller-owned scratch of at least length() elements,
+    // so repeated transforms do not allocate.
+    template<typename T> void exec(T c[], T0 fct, bool r2hc, T *ch) const
+      {
+      if (length==1) { c[0]*=fct; return; }
+      size_t nf=fact.size();
+      T *p1=c, *p2=ch;
 
       if (r2hc)
         for(size_t k1=0, l1=length; k1<nf;++k1)
@@ -2688,6 +2696,11 @@ template<typename T0> class pocketfft_r
     template<typename T> POCKETFFT_NOINLINE void exec(T c[], T0 fct, bool fwd) const
       { packplan ? packplan->exec(c,fct,fwd) : blueplan->exec_r(c,fct,fwd); }
 
+    // Scratch of at least length() elements is only used by the FFTPACK plan,
+    // the Bluestein fallback still allocates internally.
+    template<typename T> POCKETFFT_NOINLINE void exec(T c[], T0 fct, bool fwd, T *scratch) const
+      { packplan ? packplan->exec(c,fct,fwd,scratch) : blueplan->exec_r(c,fct,fwd); }
+
     size_t length() const { return len; }
   };
 
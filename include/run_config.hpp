@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fileio.hpp"
+#include "fixed_fft.hpp"
+#include "fixed_point.hpp"
+#include "window.hpp"
+
+// Stage outputs that can be dumped, combined as a bit mask
+enum Tap : unsigned {
+    TapFrames   = 1u << 0,      // Windowed frames
+    TapFFT      = 1u << 1,      // Scaled FFT of each frame
+    TapPSD      = 1u << 2,      // Signal PSD of each frame
+    TapNoisePSD = 1u << 3,      // Estimated noise PSD of each frame
+    TapSignal   = 1u << 4,      // Reconstructed signal
+    TapNone     = 0,
+    TapAll      = TapFrames | TapFFT | TapPSD | TapNoisePSD | TapSignal
+};
+
+// Settings of a single run, filled from the command line
+struct RunConfig {
+    std::string input_file = "audio_file.txt";
+    std::string output_dir = "out";
+    OutputFormat format = OutputFormat::Text;
+    size_t channels = 1;                // Interleaved channels of raw int16 inputs, WAV files carry their own
+    size_t sample_rate = 48000;         // Sample rate of raw and text inputs, WAV files carry their own
+
+    size_t frame_size = 256;            // N of a generated window, a power of two from 64 to 8192
+    size_t overlap = 2;                 // Frames covering each sample: 1, 2, 4 or 8 for 0, 50, 75 or 87.5% overlap
+    WindowType window = WindowType::Hann;
+    // Q15 hex window coefficients, one per line, used as is; empty generates window instead (--window). The
+    // default is the symmetric Q15 Hann of the hardware, whose count sets the frame size.
+    std::string window_file = "include/coeffs_hex.mem";
+    bool single_precision = false;      // Run the chain in float (FloatDenoiseEngine) instead of double
+    bool fixed_point = false;           // Run the noise estimator and Wiener filter bit-true in fixed point...
+    FixedPointConfig fixed_point_config;    // ...in these word formats
+    bool fixed_fft = false;             // Run the FFT and IFFT bit-accurately in block floating point...
+    FixedFFTConfig fixed_fft_config;    // ...with these word lengths, instead of pocketfft
+    size_t block_frames = 1;            // Frames per batched FFT/IFFT, 1 processes frame by frame
+    bool split_bins = false;            // Split the bins of each frame across the --jobs threads
+    bool realtime = false;              // Feed the input one hop at a time through the real-time interface
+    bool live = false;                  // Run capture, DSP and playback on separate threads linked by SPSC rings
+    double live_speed = 0.0;            // Capture pace in multiples of real time, 0 as fast as possible
+
+    std::string batch_path;             // Manifest file or directory of inputs, empty for a single input
+    size_t jobs = 0;                    // Worker threads of a batch or of a block run, 0 for one per hardware thread
+    size_t noise_window = 64;           // d, frames of the minimum statistics window of the noise estimator
+
+    unsigned taps = TapAll;             // Outputs written, a tap left out is never opened nor computed
+    size_t tap_every = 1;               // Per-frame taps are recorded every Nth frame...
+    size_t tap_first = 0;               // ...from this frame...
+    size_t tap_last = SIZE_MAX;         // ...up to this one (inclusive)
+
+    size_t hopSize() const { return frame_size / overlap; }
+    bool enabled(Tap tap) const { return (taps & tap) != 0; }
+    bool recordsFrame(size_t frame) const {
+        return frame >= tap_first && frame <= tap_last && (frame - tap_first) % tap_every == 0;
+    }
+    // Path of an output file inside output_dir, with the extension of the output format
+    std::string outputPath(const std::string& name) const;
+};
+
+// Parses the command line, throws std::invalid_argument on unknown or malformed options
+RunConfig parseRunConfig(int argc, char* argv[]);
+
+// Analysis window of the run: window_file as is, or the generated window COLA-normalized for the hop.
+// Throws std::runtime_error when the hop does not divide the coefficients of the window file.
+std::vector<float> makeAnalysisWindow(const RunConfig& config);
+
+// Usage text listing the options understood by parseRunConfig
+const char* runConfigUsage();
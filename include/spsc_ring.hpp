@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include "aligned_allocator.hpp"
+
+// Wait-free single-producer/single-consumer ring buffer. Exactly one thread writes and one thread reads;
+// neither of them ever blocks, locks or allocates after construction. The read and write indices live on
+// separate cache lines, and each side caches the other side's index so it only touches that line when
+// its cached view runs out.
+template <typename T>
+class SpscRing {
+    private:
+        aligned_vector<T> buffer;
+        size_t mask;                                            // Capacity - 1, the capacity is a power of two
+
+        alignas(kCacheLine) std::atomic<size_t> head{0};        // Items read so far, written by the consumer
+        size_t cached_tail = 0;                                 // Consumer's last view of tail
+        alignas(kCacheLine) std::atomic<size_t> tail{0};        // Items written so far, written by the producer
+        size_t cached_head = 0;                                 // Producer's last view of head
+
+        static size_t roundUp(size_t n) {
+            size_t capacity = 1;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+    public:
+        // Holds at least min_capacity items
+        explicit SpscRing(size_t min_capacity)
+            : buffer(roundUp(min_capacity)), mask(roundUp(min_capacity) - 1) {}
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        size_t capacity() const { return mask + 1; }
+
+        // Producer side: copies up to n items in, returns how many fit
+        size_t write(const T* data, size_t n) {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (capacity() - (t - cached_head) < n) {
+                cached_head = head.load(std::memory_order_acquire);
+            }
+            n = std::min(n, capacity() - (t - cached_head));
+            const size_t first = std::min(n, capacity() - (t & mask));
+            std::copy(data, data + first, buffer.begin() + (t & mask));
+            std::copy(data + first, data + n, buffer.begin());
+            tail.store(t + n, std::memory_order_release);
+            return n;
+        }
+        size_t writeAvailable() {
+            cached_head = head.load(std::memory_order_acquire);
+            return capacity() - (tail.load(std::memory_order_relaxed) - cached_head);
+        }
+
+        // Consumer side: copies up to n items out, returns how many were available
+        size_t read(T* data, size_t n) {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (cached_tail - h < n) {
+                cached_tail = tail.load(std::memory_order_acquire);
+            }
+            n = std::min(n, cached_tail - h);
+            const size_t first = std::min(n, capacity() - (h & mask));
+            std::copy(buffer.begin() + (h & mask), buffer.begin() + (h & mask) + first, data);
+            std::copy(buffer.begin(), buffer.begin() + (n - first), data + first);
+            head.store(h + n, std::memory_order_release);
+            return n;
+        }
+        size_t readAvailable() {
+            cached_tail = tail.load(std::memory_order_acquire);
+            return cached_tail - head.load(std::memory_order_relaxed);
+        }
+};
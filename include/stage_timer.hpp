@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Hot-path stages timed by StageTimer
+enum class Stage : unsigned { Window, FFT, PSD, Noise, Wiener, IFFT, OLA, Write, Count };
+constexpr size_t kStageCount = static_cast<size_t>(Stage::Count);
+
+const char* stageName(Stage stage);
+
+// Timers are compiled in with -DAUDIOFILTER_PROFILE (CMake option AUDIOFILTER_ENABLE_PROFILING).
+// Without it StageTimer is an empty object and the functions below report nothing.
+#ifdef AUDIOFILTER_PROFILE
+constexpr bool kStageTimersEnabled = true;
+#else
+constexpr bool kStageTimersEnabled = false;
+#endif
+
+// Adds one call of ns nanoseconds to the statistics of stage. Each thread records into its own
+// counters, so timed code on several threads never contends.
+void recordStage(Stage stage, uint64_t ns);
+
+// Registers the counters of the calling thread, which its first recordStage() would otherwise allocate
+// under a lock. Threads running allocation-free code call it before entering that code.
+void registerStageTimerThread();
+
+// Times the enclosing scope as one call of a stage
+class StageTimer {
+#ifdef AUDIOFILTER_PROFILE
+    private:
+        Stage stage;
+        std::chrono::steady_clock::time_point start;
+    public:
+        explicit StageTimer(Stage stage_param) : stage(stage_param), start(std::chrono::steady_clock::now()) {}
+        ~StageTimer() {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            recordStage(stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+#else
+    public:
+        explicit StageTimer(Stage) {}
+#endif
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+};
+
+// Statistics of a stage over all threads, in nanoseconds. Percentiles come from a histogram with 8
+// buckets per octave, so they are accurate to about 5%.
+struct StageSummary {
+    Stage stage;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    uint64_t max = 0;
+};
+
+// Statistics of every stage, can be called at any time
+std::vector<StageSummary> stageSummary();
+
+// Table of the stages with at least one call: calls, total, mean, p50, p99 and max
+void printStageTimers(std::ostream& out);
+
+// Clears the statistics of every thread, only while no timed code runs
+void resetStageTimers();
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads consuming a FIFO of tasks
+class ThreadPool {
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable task_ready;
+        std::condition_variable all_done;
+        size_t pending;                             // Tasks queued or running
+        bool stopping;
+        std::exception_ptr error;                   // First exception thrown by a task
+
+        void workerLoop();
+    public:
+        // num_threads = 0 uses one thread per hardware thread
+        explicit ThreadPool(size_t num_threads = 0);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task);
+        // Blocks until every submitted task finished, rethrows the first exception thrown by a task
+        void wait();
+        size_t size() const { return workers.size(); }
+};
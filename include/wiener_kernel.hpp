@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <complex>
+
+// Instruction sets with a dedicated Wiener gain kernel
+enum class SimdLevel { Scalar, AVX2, AVX512, NEON };
+
+// Best instruction set supported by the running CPU
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Decision-directed Wiener gain over num_bins bins. Updates the recursive p_xi/p_SNR state and writes
+// X(k) * ξ/(1+ξ) into out, which may alias X. Every variant performs the same IEEE operations in the
+// same order without FMA contraction, so all of them match the scalar kernel bit for bit (0 ULP). Only
+// the sign and payload of a NaN may differ, when two NaNs meet in one operation.
+// T is double for the reference chain, float for the single-precision one.
+template <typename T>
+using BasicWienerGainKernel = void (*)(size_t num_bins, const std::complex<T>* X, const T* psd,
+                                       const T* psd_noise_est, T* p_xi, T* p_SNR,
+                                       std::complex<T>* out, T alpha_w, T alpha_snr);
+using WienerGainKernel = BasicWienerGainKernel<double>;
+
+// Kernel for the given instruction set, falls back to the scalar kernel when it is not compiled in
+WienerGainKernel wienerGainKernel(SimdLevel level);
+// Same for precision T, double or float
+template <typename T>
+BasicWienerGainKernel<T> wienerGainKernel(SimdLevel level);
+template <> BasicWienerGainKernel<double> wienerGainKernel<double>(SimdLevel level);
+template <> BasicWienerGainKernel<float> wienerGainKernel<float>(SimdLevel level);
@@ -0,0 +1,26 @@
+// window.hpp
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Analysis windows generated at startup
+enum class WindowType {
+    Hann,
+    SqrtHann,
+    Hamming,
+    Blackman,
+    Rectangular
+};
+
+const char* windowTypeName(WindowType type);
+
+// Periodic (DFT-even) window of frame_size points, COLA-normalized for the given hop (see normalizeCola)
+std::vector<float> makeWindow(WindowType type, size_t frame_size, size_t hop);
+
+// Scales the window so that its copies shifted by hop add up to exactly 1, which makes the overlap-add of
+// unmodified frames reproduce the input without a synthesis window. Windows that are COLA at that hop
+// (Hann and Hamming at 50/75/87.5%, Blackman at 75/87.5%, rect at any hop) are only scaled; the others
+// (sqrt-hann, Blackman at 50%) are divided sample by sample by the sum of the copies covering that sample.
+// Throws std::invalid_argument when the hop does not divide the window or leaves a sample without gain
+// (Hann or Blackman without overlap).
+void normalizeCola(std::vector<float>& window, size_t hop);
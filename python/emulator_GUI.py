@@ -1,5 +1,6 @@
 import matplotlib.pyplot as plt
 import numpy as np
+import os
 import load_file
 import scipy.io.wavfile as wav
 from quant_tool import FixedPointValue
@@ -118,11 +119,11 @@ class EmulatorGUI:
         """Load all required data files"""
         try:
             self.samples = load_file.load_samples(self.samples_file)
-            self.windowed_frames = load_file.load_windowed_frames(self.windowed_frames_file)
-            self.fft_res = load_file.load_fft_results(self.fft_results_file)
-            self.psd_est_noise = load_file.load_windowed_frames(self.psd_est_noise_file)
-            self.psd_signal = load_file.load_windowed_frames(self.psd_signal_file)
-            self.recon_signal = load_file.load_signal(self.recon_signal_file)
+            self.windowed_frames = self.load_output(self.windowed_frames_file, load_file.load_windowed_frames)
+            self.fft_res = self.load_output(self.fft_results_file, load_file.load_fft_results)
+            self.psd_est_noise = self.load_output(self.psd_est_noise_file, load_file.load_windowed_frames)
+            self.psd_signal = self.load_output(self.psd_signal_file, load_file.load_windowed_frames)
+            self.recon_signal = self.load_output(self.recon_signal_file, load_file.load_signal)
             to_wav(self.recon_signal, self.audio_file2)
             self.status_var.set("All data loaded successfully!")
             print("All data loaded successfully!")
@@ -132,6 +133,14 @@ class EmulatorGUI:
             messagebox.showerror("Error", error_msg)
             self.root.destroy()
 
+    def load_output(self, txt_file, txt_loader):
+        """Loads the binary (.bin) dump of an output if it is newer than the text one"""
+        bin_file = os.path.splitext(txt_file)[0] + ".bin"
+        if os.path.exists(bin_file) and (not os.path.exists(txt_file)
+                                         or os.path.getmtime(bin_file) >= os.path.getmtime(txt_file)):
+            return load_file.load_binary(bin_file)
+        return txt_loader(txt_file)
+
     def on_closing(self):
         """Properly close the application"""
         try:
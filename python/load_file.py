@@ -33,4 +33,20 @@ def load_fft_results(filepath):
 def load_signal(filepath):
     with open(filepath) as f:
         data = np.loadtxt(f, delimiter=' ', dtype=np.float64)
-    return data
\ No newline at end of file
+    return data
+
+BINARY_HEADER = np.dtype([('magic', 'S8'), ('version', '<u4'), ('dtype', '<u4'),
+                          ('frame_size', '<u8'), ('num_frames', '<u8')])
+BINARY_DTYPES = {1: np.dtype('<f8'), 2: np.dtype('<c16')}
+
+def load_binary(filepath):
+    """Memory-maps a binary frame container written by the C++ backend (--binary).
+    Returns a (num_frames, frame_size) array, or a 1D array for signals (frame_size == 1)."""
+    header = np.fromfile(filepath, dtype=BINARY_HEADER, count=1)[0]
+    if header['magic'] != b'AFSFRAME' or header['version'] != 1:
+        raise ValueError(f"Not a binary frame file: {filepath}")
+    frame_size = int(header['frame_size'])
+    num_frames = int(header['num_frames'])
+    data = np.memmap(filepath, dtype=BINARY_DTYPES[int(header['dtype'])], mode='r',
+                     offset=BINARY_HEADER.itemsize, shape=(num_frames, frame_size))
+    return data.reshape(-1) if frame_size == 1 else data
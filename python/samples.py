@@ -6,6 +6,7 @@ from quant_tool import FixedPointValue
 fs = 48000
 i_file = "audio_files/unfiltered_samples.wav"
 o_file = "audio_file.txt"
+o_file_pcm = "audio_file.pcm"
 
 fs_d, data = wav.read(i_file)
 if fs != fs_d:
@@ -34,4 +35,6 @@ for val in data_float:
         print(f"Error: {e}")
         continue
 
-np.savetxt(o_file, data_bin, fmt="%s")
\ No newline at end of file
+np.savetxt(o_file, data_bin, fmt="%s")
+# Same Q15 samples as raw little-endian int16, read much faster by the C++ backend
+np.round(np.array(data_q15) * 32768).astype('<i2').tofile(o_file_pcm)
@@ -3,72 +3,88 @@
 #include <iomanip>
 
 //Minimum Statistics Noise Estimator
-NoiseEstimator::NoiseEstimator(size_t num_bins_param, size_t d_param)
+// The history starts filled with d frames of 1.0, which also are the suffix minima of that block
+template <typename T>
+BasicNoiseEstimator<T>::BasicNoiseEstimator(size_t num_bins_param, size_t d_param)
 : num_bins(num_bins_param), d(d_param), psd_smoothed(num_bins_param, 0.0), 
-psd_history_buffer (num_bins_param,std::vector<double>(d_param, 1.0)),
-psd_noise_est(num_bins_param, 1e-10), bias_comp(num_bins_param, 1.2), idx(0){}
+psd_noise_est(num_bins_param, T(1e-10)), bias_comp(T(1.2)),
+stride(paddedCount<T>(num_bins_param)), psd_history_buffer(d_param * stride, 1.0),
+psd_prefix_min(stride, 1.0), pos(0){}
 
-void NoiseEstimator::update(const std::vector<double>& current_power_spectrum){
-    double alpha = 0.8; // α - smoothing factor
-    for (size_t i = 0; i < num_bins; i++){
-        // Smoothe the PSD in the current bin
-        // P_noise_smoothed[i] = α * P_noise_smoothed[i] + (1-α) * P_min[i] -> Leaky Integrator
-        psd_smoothed[i] = (alpha * psd_smoothed[i]) + ((1 - alpha) * current_power_spectrum[i]);
-
-        // Copy the smoothed psd up to the current frame into the buffer
-        psd_history_buffer[i][idx] = psd_smoothed[i]; 
-
-        // Find the minimum power value in the bin across the d frames
-        auto min_psd = *std::min_element(psd_history_buffer[i].begin(), psd_history_buffer[i].end());
+template <typename T>
+void BasicNoiseEstimator<T>::updateBins(const T* current_power_spectrum, size_t first, size_t last){
+    dsp_kernel::minStatsUpdate(current_power_spectrum, psd_smoothed.data(), psd_noise_est.data(),
+                               psd_history_buffer.data(), psd_prefix_min.data(), pos, first, last, stride, d,
+                               bias_comp);
+}
 
-        // Apply the bias compensation factor
-        psd_noise_est[i] = bias_comp[i] * min_psd;
-        // psd_noise_est[i] = 0.0003;
-    }
-    idx = (idx + 1) % d; // Increment the frame index within the d limit of frames in history
+template <typename T>
+void BasicNoiseEstimator<T>::advance(){
+    pos = (pos + 1 < d) ? pos + 1 : 0;
 }
 
-const std::vector<double>& NoiseEstimator::getNoiseEstimate() const{
+template <typename T>
+const std::vector<T>& BasicNoiseEstimator<T>::getNoiseEstimate() const{
     return psd_noise_est;
 }
 
 
 // Decision-Directed approach on Wiener filter
-WienerFilter::WienerFilter(size_t frame_size_param)
-                :frame_size(frame_size_param), p_xi(frame_size_param,0.0),
-                p_wiener_gain(frame_size_param,0.0), p_SNR(frame_size_param,1e-10){}
+template <typename T>
+BasicWienerFilter<T>::BasicWienerFilter(size_t frame_size_param, size_t channels, SimdLevel simd)
+                :frame_size(frame_size_param), num_bins(channels * ((frame_size_param / 2) + 1)),
+                p_xi(num_bins,T(0)), p_wiener_gain(num_bins,T(0)), p_SNR(num_bins,T(1e-10)),
+                kernel(wienerGainKernel<T>(simd)){}
+
+template <typename T>
+std::vector<std::complex<T>> BasicWienerFilter<T>::apply(
+    const std::vector<std::complex<T>>& current_frame,          // Current frame's spectrum
+    const std::vector<T>& psd,                                  // PSD of the unfiltered signal (voice + noise)
+    const std::vector<T>& psd_noise_est                         // PSD of the estimated noise in the frame   
+){
+    std::vector<std::complex<T>> filtered_signal_fft(num_bins);
+    apply(current_frame.data(), psd.data(), psd_noise_est.data(), filtered_signal_fft.data());
+    return filtered_signal_fft;
+}
 
-std::vector<std::complex<double>> WienerFilter::apply(
-    const std::vector<std::complex<double>>& current_frame,     // Current frame's spectrum
-    const std::vector<double>& psd,                             // PSD of the unfiltered signal (voice + noise)
-    const std::vector<double>& psd_noise_est                    // PSD of the estimated noise in the frame   
+template <typename T>
+void BasicWienerFilter<T>::applyBins(
+    size_t first, size_t last,                                  // Range of bins to filter
+    const std::complex<T>* current_frame,                       // Current frame's spectrum
+    const T* psd,                                               // PSD of the unfiltered signal (voice + noise)
+    const T* psd_noise_est,                                     // PSD of the estimated noise in the frame
+    std::complex<T>* filtered_signal_fft                        // Filtered spectrum, may alias current_frame
 ){
     // X(k,n) = S(k,n) + W(k,n)
     // |X(k, n)|² : PSD of the unfiltered signal.
     // |Ŵ(k, n)|² : PSD of the estimated noise signal.
     // |Ŝ(k, n)|² : PSD of the estimated clean voice signal.
 
-    double alpha_w = 0.35;   // Smoothing factor for Decision-Directed approach
-    double alpha_snr = 0.15; // Smoothing factor for SNR
-    size_t fft_size = (frame_size / 2) + 1;
-    std::vector<std::complex<double>> filtered_signal_fft(fft_size);
-    for (size_t k = 0; k < fft_size; k++){
-        double SNR = (alpha_snr * p_SNR[k]) + ((1 - alpha_snr) * (psd[k] / (psd_noise_est[k])));
+    T alpha_w = T(0.35);   // Smoothing factor for Decision-Directed approach
+    T alpha_snr = T(0.15); // Smoothing factor for SNR
+    // SNR smoothing, Decision-Directed ξ(k, n) and Ŝ(k, n) = ξ(k, n) / (1 + ξ(k, n)) * X(k,n) per bin,
+    // see wiener_kernel.cpp
+    kernel(last - first, current_frame + first, psd + first, psd_noise_est + first, p_xi.data() + first,
+           p_SNR.data() + first, filtered_signal_fft + first, alpha_w, alpha_snr);
+}
+
 
-        double term1 = alpha_w * p_xi[k];                                     
-        double term2 = (1 - alpha_w) * std::max((SNR - 1),1e-10);  // Decision-Directed "voice detection"
-        
-        // Current a priori SNR using Decision-Directed approach
-        // ξ(k, n) = α_dd * (ξ(k, n-1)) + (1 - α_dd) * max((|X(k, n)|² / |Ŵ(k, n)|²) - 1, 0 )
-        double xi = term1 + (term2);
+template <typename T>
+void scaleSpectrum(std::complex<T>* spectrum, T* psd, size_t frame_size){
+    dsp_kernel::scaleSpectrum(spectrum, psd, frame_size);
+}
 
-        // Ŝ(k, n) = ξ(k, n) / (1 + ξ(k, n)) * X(k,n)
-        double wiener_gain = std::isnan(xi) ? 0.0 : xi / (1.0 + xi);
-        filtered_signal_fft[k] = current_frame[k] * wiener_gain;
+template <typename T>
+void overlapAdd(const T* recon, T* acc, size_t frame_size, size_t hop, bool first_frame,
+                T* out, size_t stride){
+    dsp_kernel::overlapAdd(recon, acc, frame_size, hop, first_frame, out, stride);
+}
 
-        // Store the values of the variables for the next call
-        p_xi[k] = xi;
-        p_SNR[k] = SNR;
-    }
-    return filtered_signal_fft;
-}
\ No newline at end of file
+template class BasicNoiseEstimator<double>;
+template class BasicNoiseEstimator<float>;
+template class BasicWienerFilter<double>;
+template class BasicWienerFilter<float>;
+template void scaleSpectrum<double>(std::complex<double>*, double*, size_t);
+template void scaleSpectrum<float>(std::complex<float>*, float*, size_t);
+template void overlapAdd<double>(const double*, double*, size_t, size_t, bool, double*, size_t);
+template void overlapAdd<float>(const float*, float*, size_t, size_t, bool, float*, size_t);
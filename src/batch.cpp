@@ -0,0 +1,96 @@
+#include "batch.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace fs = std::filesystem;
+
+std::vector<std::string> listBatchInputs(const std::string& path) {
+    std::vector<std::string> inputs;
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::directory_iterator(path)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (entry.is_regular_file() && (ext == ".wav" || ext == ".pcm" || ext == ".raw" || ext == ".txt")) {
+                inputs.push_back(entry.path().string());
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    std::ifstream manifest(path);
+    if (!manifest) {
+        throw std::runtime_error("Could not open batch manifest: " + path);
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        const size_t last = line.find_last_not_of(" \t\r");
+        inputs.push_back(line.substr(first, last - first + 1));
+    }
+    return inputs;
+}
+
+BatchReport runBatch(const RunConfig& config, const std::vector<std::string>& inputs,
+                     const std::vector<float>& window, size_t hop, size_t d) {
+    struct Job {
+        RunConfig config;
+        uintmax_t bytes;
+    };
+
+    // One output directory per file, named after its stem and made unique when stems repeat
+    std::vector<Job> jobs;
+    std::set<std::string> names;
+    for (const auto& input : inputs) {
+        std::string name = fs::path(input).stem().string();
+        for (size_t n = 1; !names.insert(name).second; n++) {
+            name = fs::path(input).stem().string() + "_" + std::to_string(n);
+        }
+        Job job{config, 0};
+        job.config.input_file = input;
+        job.config.output_dir = (fs::path(config.output_dir) / name).string();
+        job.config.jobs = 1;                                      // Files are the parallel units, not their frames
+        std::error_code ec;
+        job.bytes = fs::file_size(input, ec);
+        jobs.push_back(std::move(job));
+    }
+    // Longest files first, so a long file started last does not leave the other threads idle
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.bytes > b.bytes; });
+
+    BatchReport report;
+    report.files = jobs.size();
+    std::mutex report_mutex;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(config.jobs);
+        for (const auto& job : jobs) {
+            pool.submit([&, job_config = &job.config] {
+                try {
+                    const size_t frames = denoiseFile(*job_config, window, hop, d);
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    report.frames += frames;
+                    std::cout << "--- " << job_config->input_file << ": " << frames << " frames" << std::endl;
+                } catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    report.failed++;
+                    std::cerr << "--- " << job_config->input_file << " failed: " << e.what() << std::endl;
+                }
+            });
+        }
+        pool.wait();
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
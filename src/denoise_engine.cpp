@@ -0,0 +1,348 @@
+#include "denoise_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include "stage_timer.hpp"
+// #define FREQ_DEBUG
+
+template <typename T>
+BasicDenoiseEngine<T>::BasicDenoiseEngine(const std::vector<float>& window, size_t hop_param, size_t d, size_t channels_param)
+    : frame_size(window.size()), hop(hop_param), fft_size((window.size() / 2) + 1), channels(channels_param), d(d),
+      frame(window.size(), window), fft(window.size()), noise_est(channels_param * fft_size, d),
+      filter(window.size(), channels_param), windowed_frame(channels_param * frame_size),
+      res(channels_param * fft_size), psd(channels_param * fft_size), filtered_frame(channels_param * fft_size),
+      recon_frame(channels_param * frame_size), overlap(channels_param * frame_size, 0.0), frame_counter(0),
+      input(channels_param * frame_size), filled(0), output(channels_param * (frame_size + hop_param), 0.0),
+      output_head(0), output_count(channels_param * (frame_size - 1)), block_out(channels_param * hop_param) {
+    if (hop == 0 || hop > frame_size || frame_size % hop != 0) {
+        throw std::invalid_argument("Hop must divide the frame size");
+    }
+    if (channels == 0) {
+        throw std::invalid_argument("A stream needs at least one channel");
+    }
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::processFrame(const float* samples, T* out) {
+    {
+        // 1. Generate windowed frame
+        StageTimer timer(Stage::Window);
+        for (size_t c = 0; c < channels; c++){
+            frame.generateFrame(samples + c, &windowed_frame[c * frame_size], channels);
+        }
+    }
+    {
+        // 2. Apply FFT
+        // Compute the R2C DFT (no scaling)
+        StageTimer timer(Stage::FFT);
+        for (size_t c = 0; c < channels; c++){
+            fft.forward(&windowed_frame[c * frame_size], &res[c * fft_size]);
+        }
+    }
+
+    // Analyze the frequency spectrum
+    #ifdef FREQ_DEBUG
+    // Compute frequency bins and magnitudes
+    std::vector<double> freqs(res.size());
+    std::vector<double> mags(res.size());
+    std::vector<double> esd(res.size());
+    const double f_bin = sample_rate / frame_size; 
+    res[0] *= 0.001;
+    res[1] *= 0.001;
+    for (size_t k = 0; k < res.size(); ++k) {
+        freqs[k] = k * f_bin;             
+        mags[k] = std::abs(res[k]) * 2.0/frame_size;  
+        esd[k] = mags[k] * mags[k];
+    }
+    mags[0] /= 2.0;                       
+    if (frame_size % 2 == 0) {
+        mags.back() /= 2.0;            
+    }
+
+    // Find peak frequency
+    auto peak_it = std::max_element(mags.begin(), mags.end());
+    size_t peak_bin = std::distance(mags.begin(), peak_it);
+    double peak_freq = freqs[peak_bin];
+
+    // Print results
+    // std::cout << "Peak frequency: " << peak_freq << "\n";
+    // std::cout << "Bin number: " << peak_bin << "\n";
+    // std::cout << "FFT bin size: " << f_bin << " Hz/bin\n";
+    // std::cout << "Magnitude at peak: " << *peak_it << "\n";
+    #endif
+
+    {
+        StageTimer timer(Stage::PSD);
+        analyzeSpectrum(res.data(), psd.data());
+    }
+    filterSpectrum(res.data(), psd.data(), filtered_frame.data());
+
+    {
+        // 5. Apply IFFT
+        // Compute the C2R DFT (no scaling)
+        StageTimer timer(Stage::IFFT);
+        for (size_t c = 0; c < channels; c++){
+            fft.inverse(&filtered_frame[c * fft_size], &recon_frame[c * frame_size]);
+        }
+    }
+
+    // 6. Compute Overlap-add
+    StageTimer timer(Stage::OLA);
+    overlapAdd(recon_frame.data(), out);
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::setThreadPool(ThreadPool* pool_param) {
+    pool = pool_param;
+    worker_ffts.clear();
+    if (pool) {
+        for (size_t t = 0; t < pool->size(); t++){
+            worker_ffts.push_back(std::make_unique<BasicFFTEngine<T>>(frame_size));
+            if (fixed_fft) worker_ffts.back()->setFixedPoint(fixed_fft_config);
+        }
+    }
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::setFixedPoint(const FixedPointConfig& config) {
+    fixed_stage = std::make_unique<FixedPointStage<T>>(channels * fft_size, d, config);
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::setFixedFFT(const FixedFFTConfig& config) {
+    fft.setFixedPoint(config);
+    for (auto& worker_fft : worker_ffts) {
+        worker_fft->setFixedPoint(config);
+    }
+    fixed_fft = true;
+    fixed_fft_config = config;
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::parallelFor(size_t count, const std::function<void(size_t, size_t, BasicFFTEngine<T>&)>& task) {
+    const size_t workers = pool ? std::min(pool->size(), count) : 1;
+    if (workers <= 1) {
+        task(0, count, fft);
+        return;
+    }
+    for (size_t t = 0; t < workers; t++){
+        const size_t first = count * t / workers;
+        const size_t last = count * (t + 1) / workers;
+        pool->submit([&task, first, last, worker_fft = worker_ffts[t].get()] { task(first, last, *worker_fft); });
+    }
+    pool->wait();
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::processFrames(const float* samples, size_t count, T* out) {
+    const size_t frame_len = frame_size * channels;
+    const size_t bins_len = fft_size * channels;
+    const size_t hop_len = hop * channels;
+    if (count * frame_len > block_frames.size()) {
+        block_frames.resize(count * frame_len);
+        block_spectra.resize(count * bins_len);
+        block_psd.resize(count * bins_len);
+        block_noise.resize(count * bins_len);
+        block_filtered.resize(count * bins_len);
+        block_recon.resize(count * frame_len);
+    }
+
+    // Analysis, independent per frame: 1. window, 2. batched FFT, scaling and PSD
+    // Each stage of a worker's range of frames is timed as one call
+    parallelFor(count, [&](size_t first, size_t last, BasicFFTEngine<T>& worker_fft) {
+        {
+            StageTimer timer(Stage::Window);
+            for (size_t j = first; j < last; j++){
+                for (size_t c = 0; c < channels; c++){
+                    frame.generateFrame(samples + j * hop_len + c, &block_frames[j * frame_len + c * frame_size], channels);
+                }
+            }
+        }
+        {
+            StageTimer timer(Stage::FFT);
+            worker_fft.forward(&block_frames[first * frame_len], &block_spectra[first * bins_len], (last - first) * channels);
+        }
+        StageTimer timer(Stage::PSD);
+        for (size_t j = first; j < last; j++){
+            analyzeSpectrum(&block_spectra[j * bins_len], &block_psd[j * bins_len]);
+        }
+    });
+
+    // 3-4. The noise estimate and the Wiener gain are recursive, frames go through them in order
+    const std::vector<T>& psd_noise = noisePSD();
+    for (size_t j = 0; j < count; j++){
+        filterSpectrum(&block_spectra[j * bins_len], &block_psd[j * bins_len], &block_filtered[j * bins_len]);
+        std::copy(psd_noise.begin(), psd_noise.end(), block_noise.begin() + j * bins_len);
+    }
+
+    // Synthesis, independent per frame: 5. batched IFFT, 6. overlap-add of the hops each frame completes
+    parallelFor(count, [&](size_t first, size_t last, BasicFFTEngine<T>& worker_fft) {
+        StageTimer timer(Stage::IFFT);
+        worker_fft.inverse(&block_filtered[first * bins_len], &block_recon[first * frame_len], (last - first) * channels);
+    });
+    parallelFor(count, [&](size_t first, size_t last, BasicFFTEngine<T>&) {
+        StageTimer timer(Stage::OLA);
+        for (size_t j = first; j < last; j++){
+            for (size_t c = 0; c < channels; c++){
+                for (size_t i = 0; i < hop; i++){
+                    out[j * hop_len + i * channels + c] = overlapSum(j * hop + i, c, count);
+                }
+            }
+        }
+    });
+
+    // Carry the partial sums of the last frames over to the next call, reads stay ahead of writes
+    StageTimer timer(Stage::OLA);
+    for (size_t c = 0; c < channels; c++){
+        for (size_t k = 0; k < frame_size - hop; k++){
+            overlap[c * frame_size + k] = overlapSum(count * hop + k, c, count);
+        }
+    }
+    frame_counter += count;
+}
+
+template <typename T>
+T BasicDenoiseEngine<T>::overlapSum(size_t p, size_t c, size_t count) const {
+    // Frames of the block covering p, and the partial sum carried over from the previous frames
+    size_t f = (p >= frame_size) ? (p - frame_size) / hop + 1 : 0;
+    const size_t f_end = std::min(count, p / hop + 1);
+    bool started = (frame_counter > 0 && p < frame_size - hop);
+    T sum = started ? overlap[c * frame_size + p] : 0.0;
+    // Same order of additions as overlapAdd(), so the result is bit-identical
+    for (; f < f_end; f++){
+        const T r = block_recon[(f * channels + c) * frame_size + p - f * hop];
+        sum = started ? r + sum : r;
+        started = true;
+    }
+    return sum;
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::analyzeSpectrum(std::complex<T>* spectrum, T* frame_psd) const {
+    for (size_t c = 0; c < channels; c++){
+        scaleSpectrum(&spectrum[c * fft_size], &frame_psd[c * fft_size], frame_size);
+    }
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::filterSpectrum(std::complex<T>* spectrum, T* frame_psd, std::complex<T>* filtered) {
+    if (fixed_stage) {
+        {
+            StageTimer timer(Stage::Noise);
+            fixed_stage->estimateNoise(spectrum, frame_psd);
+        }
+        StageTimer timer(Stage::Wiener);
+        fixed_stage->filterSpectrum(filtered);
+        return;
+    }
+    const std::vector<T>& psd_noise = noise_est.getNoiseEstimate();
+    const size_t num_bins = noise_est.binCount();
+    const size_t workers = (split_bins && pool) ? std::min(pool->size(), num_bins / kMinBinsPerTask) : 1;
+    if (workers <= 1) {
+        // 3. Estimate the noise PSD
+        // Update the information of the noise estimator with the PSD of the current frame, all channels at once
+        {
+            StageTimer timer(Stage::Noise);
+            noise_est.update(frame_psd);
+        }
+
+        // 4. Apply filter
+        StageTimer timer(Stage::Wiener);
+        filter.apply(spectrum, frame_psd, psd_noise.data(), filtered);
+        return;
+    }
+
+    // Same two steps with the bins split in cache-line multiples, so no two threads write to the same line
+    const size_t chunk = paddedCount<T>((num_bins + workers - 1) / workers);
+    for (size_t first = 0; first < num_bins; first += chunk){
+        const size_t last = std::min(num_bins, first + chunk);
+        pool->submit([=, &psd_noise] {
+            {
+                StageTimer timer(Stage::Noise);
+                noise_est.updateBins(frame_psd, first, last);
+            }
+            StageTimer timer(Stage::Wiener);
+            filter.applyBins(first, last, spectrum, frame_psd, psd_noise.data(), filtered);
+        });
+    }
+    pool->wait();
+    noise_est.advance();
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::overlapAdd(const T* recon_channels, T* out) {
+    for (size_t c = 0; c < channels; c++){
+        ::overlapAdd(&recon_channels[c * frame_size], &overlap[c * frame_size], frame_size, hop,
+                     frame_counter == 0, out + c, channels);
+    }
+    frame_counter++;
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::process(const float* in, size_t n, float* out) {
+    // Counts below are in interleaved samples
+    const size_t frame_len = frame_size * channels;
+    const size_t hop_len = hop * channels;
+    n *= channels;
+    while (n > 0) {
+        const size_t take = std::min(n, frame_len - filled);
+        std::copy(in, in + take, input.begin() + filled);
+        filled += take;
+
+        if (filled == frame_len) {
+            // Append the hop completed samples behind the pending ones
+            if (output_head + output_count + hop_len > output.size()) {
+                std::copy(output.begin() + output_head, output.begin() + output_head + output_count, output.begin());
+                output_head = 0;
+            }
+            processFrame(input.data(), &output[output_head + output_count]);
+            output_count += hop_len;
+
+            std::copy(input.begin() + hop_len, input.end(), input.begin());
+            filled = frame_len - hop_len;
+        }
+
+        // At least latency() + 1 samples per channel are pending whenever a frame is incomplete
+        for (size_t i = 0; i < take; i++){
+            out[i] = static_cast<float>(output[output_head + i]);
+        }
+        output_head += take;
+        output_count -= take;
+
+        in += take;
+        out += take;
+        n -= take;
+    }
+}
+
+template <typename T>
+void BasicDenoiseEngine<T>::processBlock(const float* in, float* out, size_t block_hop) {
+    const auto start = std::chrono::steady_clock::now();
+    if (block_hop != hop) {
+        throw std::invalid_argument("processBlock takes exactly one hop of samples");
+    }
+    const size_t frame_len = frame_size * channels;
+    const size_t hop_len = hop * channels;
+
+    std::copy(in, in + hop_len, input.begin() + filled);
+    filled += hop_len;
+    if (filled < frame_len) {
+        // The first frame is not complete yet
+        std::fill(out, out + hop_len, 0.0f);
+    } else {
+        processFrame(input.data(), block_out.data());
+        for (size_t i = 0; i < hop_len; i++){
+            out[i] = static_cast<float>(block_out[i]);
+        }
+        std::copy(input.begin() + hop_len, input.end(), input.begin());
+        filled = frame_len - hop_len;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    worst_block_seconds = std::max(worst_block_seconds, seconds);
+    overrun_blocks += (seconds * sample_rate > static_cast<double>(hop)) ? 1 : 0;
+    realtime_blocks++;
+}
+
+template class BasicDenoiseEngine<double>;
+template class BasicDenoiseEngine<float>;
@@ -0,0 +1,50 @@
+#include "dsp_worker.hpp"
+#include "stage_timer.hpp"
+
+DspWorker::DspWorker(DenoiseEngine& engine_param, SpscRing<float>& input_param, SpscRing<float>& output_param)
+    : engine(engine_param), input(input_param), output(output_param),
+      in_block(engine_param.hopSize() * engine_param.channelCount()),
+      out_block(engine_param.hopSize() * engine_param.channelCount()) {}
+
+DspWorker::~DspWorker() {
+    stop();
+}
+
+void DspWorker::start() {
+    if (thread.joinable()) return;
+    // A finish() issued before the start still holds: the worker drains what was queued and leaves
+    stopping.store(false);
+    done.store(false);
+    thread = std::thread([this] {
+        registerStageTimerThread();                 // Keeps the first timed block allocation-free
+        run();
+    });
+}
+
+void DspWorker::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void DspWorker::run() {
+    const size_t block_len = in_block.size();
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (input.readAvailable() < block_len) {
+            // Draining ends once no complete block is left, a partial one is never processed
+            if (draining.load(std::memory_order_acquire) && input.readAvailable() < block_len) break;
+            std::this_thread::yield();
+            continue;
+        }
+        if (output.writeAvailable() < block_len) {
+            std::this_thread::yield();
+            continue;
+        }
+        input.read(in_block.data(), block_len);
+        engine.processBlock(in_block.data(), out_block.data(), engine.hopSize());
+        output.write(out_block.data(), block_len);
+        blocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+}
@@ -0,0 +1,124 @@
+#include "fft_engine.hpp"
+#include <algorithm>
+
+template <typename T>
+BasicFFTEngine<T>::BasicFFTEngine(size_t frame_size_param)
+    : frame_size(frame_size_param), plan(frame_size_param),
+      buffer(frame_size_param), scratch(frame_size_param)
+#ifndef POCKETFFT_NO_VECTORS
+      , vbuffer(frame_size_param), vscratch(frame_size_param)
+#endif
+      {}
+
+template <typename T>
+void BasicFFTEngine<T>::setFixedPoint(const FixedFFTConfig& config) {
+    config.validate();
+    if (config.word_bits == 16) {
+        fixed16 = std::make_unique<FixedPointFFT16>(frame_size, config);
+        fixed32.reset();
+    } else {
+        fixed32 = std::make_unique<FixedPointFFT32>(frame_size, config);
+        fixed16.reset();
+    }
+}
+
+template <typename T>
+void BasicFFTEngine<T>::unpack(std::complex<T>* out) const {
+    // Unpack the halfcomplex result: r0, r1, i1, r2, i2, ..., [r(N/2)]
+    out[0] = std::complex<T>(buffer[0], 0);
+    size_t i = 1, k = 1;
+    for (; i < frame_size - 1; i += 2, ++k) {
+        out[k] = std::complex<T>(buffer[i], buffer[i + 1]);
+    }
+    if (i < frame_size) {
+        out[k] = std::complex<T>(buffer[i], 0);
+    }
+}
+
+template <typename T>
+void BasicFFTEngine<T>::pack(const std::complex<T>* in) {
+    // Pack the spectrum into halfcomplex order, imaginary parts of DC and Nyquist are dropped
+    buffer[0] = in[0].real();
+    size_t i = 1, k = 1;
+    for (; i < frame_size - 1; i += 2, ++k) {
+        buffer[i] = in[k].real();
+        buffer[i + 1] = in[k].imag();
+    }
+    if (i < frame_size) {
+        buffer[i] = in[k].real();
+    }
+}
+
+template <typename T>
+void BasicFFTEngine<T>::forward(const T* in, std::complex<T>* out) {
+    if (fixed16) return fixed16->forward(in, out);
+    if (fixed32) return fixed32->forward(in, out);
+    std::copy(in, in + frame_size, buffer.data());
+    plan.exec(buffer.data(), 1.0, true, scratch.data());
+    unpack(out);
+}
+
+template <typename T>
+void BasicFFTEngine<T>::inverse(const std::complex<T>* in, T* out) {
+    if (fixed16) return fixed16->inverse(in, out);
+    if (fixed32) return fixed32->inverse(in, out);
+    pack(in);
+    plan.exec(buffer.data(), 1.0, false, scratch.data());
+    std::copy(buffer.data(), buffer.data() + frame_size, out);
+}
+
+template <typename T>
+void BasicFFTEngine<T>::forward(const T* in, std::complex<T>* out, size_t count) {
+    const size_t num_bins = bins();
+    size_t j = 0;
+#ifndef POCKETFFT_NO_VECTORS
+    // The fixed-point transforms vectorize inside each frame
+    for (; !fixedPoint() && j + vlen <= count; j += vlen) {
+        // Frame j + v goes to lane v
+        for (size_t i = 0; i < frame_size; ++i) {
+            for (size_t v = 0; v < vlen; ++v) {
+                vbuffer[i][v] = in[(j + v) * frame_size + i];
+            }
+        }
+        plan.exec(vbuffer.data(), 1.0, true, vscratch.data());
+        for (size_t v = 0; v < vlen; ++v) {
+            for (size_t i = 0; i < frame_size; ++i) {
+                buffer[i] = vbuffer[i][v];
+            }
+            unpack(out + (j + v) * num_bins);
+        }
+    }
+#endif
+    // Frames left over from the last full vector
+    for (; j < count; ++j) {
+        forward(in + j * frame_size, out + j * num_bins);
+    }
+}
+
+template <typename T>
+void BasicFFTEngine<T>::inverse(const std::complex<T>* in, T* out, size_t count) {
+    const size_t num_bins = bins();
+    size_t j = 0;
+#ifndef POCKETFFT_NO_VECTORS
+    for (; !fixedPoint() && j + vlen <= count; j += vlen) {
+        for (size_t v = 0; v < vlen; ++v) {
+            pack(in + (j + v) * num_bins);
+            for (size_t i = 0; i < frame_size; ++i) {
+                vbuffer[i][v] = buffer[i];
+            }
+        }
+        plan.exec(vbuffer.data(), 1.0, false, vscratch.data());
+        for (size_t i = 0; i < frame_size; ++i) {
+            for (size_t v = 0; v < vlen; ++v) {
+                out[(j + v) * frame_size + i] = vbuffer[i][v];
+            }
+        }
+    }
+#endif
+    for (; j < count; ++j) {
+        inverse(in + j * num_bins, out + j * frame_size);
+    }
+}
+
+template class BasicFFTEngine<double>;
+template class BasicFFTEngine<float>;
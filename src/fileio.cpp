@@ -3,11 +3,40 @@
 #include <stdexcept>
 #include <iomanip>
 #include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <vector>
 #include <string>
 #include <iostream>
 
+static float decodeBinLine(const std::string& line) {
+    uint16_t raw_value = 0;
+    for (char c : line) {
+        raw_value = (raw_value << 1) | (c == '1' ? 1 : 0);
+    }
+
+    int16_t fixed_value;
+    if (raw_value & 0x8000) { 
+        fixed_value = static_cast<int16_t>(raw_value | 0xFFFF0000); 
+    } else {
+        fixed_value = static_cast<int16_t>(raw_value);
+    }
+    
+    return static_cast<float>(fixed_value) / 32768.0f;
+}
+
 std::vector<float> readBinData(const std::string& filename) {
     std::vector<float> samples;
     std::ifstream file(filename);
@@ -18,20 +47,7 @@ std::vector<float> readBinData(const std::string& filename) {
     
     std::string line;
     while (std::getline(file, line)) {
-        uint16_t raw_value = 0;
-        for (char c : line) {
-            raw_value = (raw_value << 1) | (c == '1' ? 1 : 0);
-        }
-
-        int16_t fixed_value;
-        if (raw_value & 0x8000) { 
-            fixed_value = static_cast<int16_t>(raw_value | 0xFFFF0000); 
-        } else {
-            fixed_value = static_cast<int16_t>(raw_value);
-        }
-        
-        float float_value = static_cast<float>(fixed_value) / 32768.0f;
-        samples.push_back(float_value);
+        samples.push_back(decodeBinLine(line));
     }
     
     return samples;
@@ -52,6 +68,28 @@ std::vector<float> readHexData(const std::string& filename) {
     return data;
 }
 
+static std::vector<float> readAll(SampleSource& source) {
+    std::vector<float> samples;
+    const size_t chunk = 4096;
+    size_t n = 0;
+    do {
+        samples.resize(samples.size() + chunk);
+        n = source.read(samples.data() + samples.size() - chunk, chunk);
+        samples.resize(samples.size() - chunk + n);
+    } while (n == chunk);
+    return samples;
+}
+
+std::vector<float> readPcm16Data(const std::string& filename) {
+    Pcm16Source source(filename);
+    return readAll(source);
+}
+
+std::vector<float> readWavData(const std::string& filename) {
+    WavSource source(filename);
+    return readAll(source);
+}
+
 void writeFrames(const std::vector<std::vector<double>>& frames, const std::string& filename) {
     if (frames.empty()) return;
 
@@ -246,4 +284,429 @@ void testReadWrite() {
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
-}
\ No newline at end of file
+}
+
+// Width of the zero-padded numFrames field, so it can be patched in place once the writer is closed
+static const int kFrameCountWidth = 10;
+
+static std::string frameCountField(size_t numFrames) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%0*zu", kFrameCountWidth, numFrames);
+    return buf;
+}
+
+BinTextSource::BinTextSource(const std::string& filename) : file(filename) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+}
+
+size_t BinTextSource::read(float* dst, size_t count) {
+    size_t n = 0;
+    while (n < count && std::getline(file, line)) {
+        dst[n++] = decodeBinLine(line);
+    }
+    return n;
+}
+
+FrameWriter::FrameWriter(const std::string& filename, size_t frameSize)
+    : file(filename), filename(filename), frameSize(frameSize), numFrames(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    file << "frameSize=" << frameSize << ",numFrames=";
+    countPos = file.tellp();
+    file << frameCountField(0) << ",type=double\n";
+    file << std::fixed << std::setprecision(15);
+}
+
+FrameWriter::~FrameWriter() {
+    try { close(); } catch (...) {}
+}
+
+void FrameWriter::write(const double* data, size_t count) {
+    if (count == 0 || count % frameSize != 0) {
+        throw std::runtime_error("Inconsistent frame size in FrameWriter: " + filename);
+    }
+    for (const double* frame = data; frame != data + count; frame += frameSize) {
+        for (size_t i = 0; i < frameSize; ++i) {
+            file << frame[i];
+            if (i < frameSize - 1) file << ",";
+        }
+        file << "\n";
+        numFrames++;
+    }
+}
+
+void FrameWriter::close() {
+    if (!file.is_open()) return;
+    file.seekp(countPos);
+    file << frameCountField(numFrames);
+    file.close();
+}
+
+FFTWriter::FFTWriter(const std::string& filename, size_t frameSize)
+    : file(filename, std::ios::binary), filename(filename), frameSize(frameSize), numFrames(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    file << "frameSize=" << frameSize << ",numFrames=";
+    countPos = file.tellp();
+    file << frameCountField(0) << ",type=complex<double>\n";
+}
+
+FFTWriter::~FFTWriter() {
+    try { close(); } catch (...) {}
+}
+
+void FFTWriter::write(const std::complex<double>* data, size_t count) {
+    if (count == 0 || count % frameSize != 0) {
+        throw std::runtime_error("Inconsistent frame size in FFTWriter: " + filename);
+    }
+    for (const std::complex<double>* frame = data; frame != data + count; frame += frameSize) {
+        for (size_t i = 0; i < frameSize; ++i) {
+            file << frame[i].real() << "," << frame[i].imag();
+            if (i < frameSize - 1) file << ",";
+        }
+        file << "\n";
+        numFrames++;
+    }
+}
+
+void FFTWriter::close() {
+    if (!file.is_open()) return;
+    file.seekp(countPos);
+    file << frameCountField(numFrames);
+    file.close();
+}
+
+SignalWriter::SignalWriter(const std::string& filename) : file(filename), numSamples(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+}
+
+void SignalWriter::write(const double* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (numSamples++ != 0) file << " ";
+        file << samples[i];
+    }
+}
+
+void SignalWriter::close() {
+    file.close();
+}
+
+static uint16_t readLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t readLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint64_t readLE64(const unsigned char* p) {
+    return static_cast<uint64_t>(readLE32(p)) | (static_cast<uint64_t>(readLE32(p + 4)) << 32);
+}
+
+static const char kBinaryMagic[8] = {'A', 'F', 'S', 'F', 'R', 'A', 'M', 'E'};
+
+static void putLE32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+static void putLE64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+static void writeBinaryHeader(std::ofstream& file, BinaryFrameType type, size_t frameSize, size_t numFrames) {
+    unsigned char header[kBinaryHeaderSize];
+    std::memcpy(header, kBinaryMagic, sizeof(kBinaryMagic));
+    putLE32(header + 8, 1);
+    putLE32(header + 12, static_cast<uint32_t>(type));
+    putLE64(header + 16, frameSize);
+    putLE64(header + 24, numFrames);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+// The container stores little-endian doubles, which is the in-memory layout on every supported target
+static void writeDoubles(std::ofstream& file, const double* data, size_t count) {
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(double)));
+}
+
+BinaryFrameWriter::BinaryFrameWriter(const std::string& filename, size_t frameSize)
+    : file(filename, std::ios::binary), filename(filename), frameSize(frameSize), numFrames(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    writeBinaryHeader(file, BinaryFrameType::Float64, frameSize, 0);
+}
+
+BinaryFrameWriter::~BinaryFrameWriter() {
+    try { close(); } catch (...) {}
+}
+
+void BinaryFrameWriter::write(const double* data, size_t count) {
+    if (count == 0 || count % frameSize != 0) {
+        throw std::runtime_error("Inconsistent frame size in BinaryFrameWriter: " + filename);
+    }
+    writeDoubles(file, data, count);
+    numFrames += count / frameSize;
+}
+
+void BinaryFrameWriter::close() {
+    if (!file.is_open()) return;
+    writeBinaryHeader(file, BinaryFrameType::Float64, frameSize, numFrames);
+    file.close();
+}
+
+BinaryFFTWriter::BinaryFFTWriter(const std::string& filename, size_t frameSize)
+    : file(filename, std::ios::binary), filename(filename), frameSize(frameSize), numFrames(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    writeBinaryHeader(file, BinaryFrameType::Complex128, frameSize, 0);
+}
+
+BinaryFFTWriter::~BinaryFFTWriter() {
+    try { close(); } catch (...) {}
+}
+
+void BinaryFFTWriter::write(const std::complex<double>* data, size_t count) {
+    if (count == 0 || count % frameSize != 0) {
+        throw std::runtime_error("Inconsistent frame size in BinaryFFTWriter: " + filename);
+    }
+    writeDoubles(file, reinterpret_cast<const double*>(data), 2 * count);
+    numFrames += count / frameSize;
+}
+
+void BinaryFFTWriter::close() {
+    if (!file.is_open()) return;
+    writeBinaryHeader(file, BinaryFrameType::Complex128, frameSize, numFrames);
+    file.close();
+}
+
+BinaryFrameView::BinaryFrameView(const std::string& filename)
+    : file(filename), dtype(BinaryFrameType::Float64), frameSize(0), numFrames(0) {
+    const unsigned char* p = file.data();
+    if (file.size() < kBinaryHeaderSize || std::memcmp(p, kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+        throw std::runtime_error("Not a binary frame file: " + filename);
+    }
+    if (readLE32(p + 8) != 1) {
+        throw std::runtime_error("Unsupported binary frame file version: " + filename);
+    }
+    const uint32_t type = readLE32(p + 12);
+    if (type != static_cast<uint32_t>(BinaryFrameType::Float64) && type != static_cast<uint32_t>(BinaryFrameType::Complex128)) {
+        throw std::runtime_error("Unsupported data type in file: " + filename);
+    }
+    dtype = static_cast<BinaryFrameType>(type);
+    frameSize = static_cast<size_t>(readLE64(p + 16));
+    numFrames = static_cast<size_t>(readLE64(p + 24));
+
+    // Divisions rather than products, which a crafted header could overflow past the size check
+    const size_t elementSize = (dtype == BinaryFrameType::Float64) ? sizeof(double) : sizeof(std::complex<double>);
+    const size_t payload = file.size() - kBinaryHeaderSize;
+    if (frameSize == 0 ||
+        (numFrames > 0 && (frameSize > payload / elementSize || numFrames > payload / (frameSize * elementSize)))) {
+        throw std::runtime_error("Invalid header in file: " + filename);
+    }
+}
+
+const double* BinaryFrameView::frame(size_t i) const {
+    if (dtype != BinaryFrameType::Float64) {
+        throw std::runtime_error("Binary frame file does not hold doubles");
+    }
+    if (i >= numFrames) {
+        throw std::out_of_range("Binary frame index out of range: " + std::to_string(i));
+    }
+    return reinterpret_cast<const double*>(file.data() + kBinaryHeaderSize) + i * frameSize;
+}
+
+const std::complex<double>* BinaryFrameView::spectrum(size_t i) const {
+    if (dtype != BinaryFrameType::Complex128) {
+        throw std::runtime_error("Binary frame file does not hold complex doubles");
+    }
+    if (i >= numFrames) {
+        throw std::out_of_range("Binary frame index out of range: " + std::to_string(i));
+    }
+    return reinterpret_cast<const std::complex<double>*>(file.data() + kBinaryHeaderSize) + i * frameSize;
+}
+
+std::unique_ptr<FrameSink> openFrameSink(const std::string& filename, size_t frameSize, OutputFormat format) {
+    if (format == OutputFormat::Binary) {
+        return std::make_unique<BinaryFrameWriter>(filename, frameSize);
+    }
+    return std::make_unique<FrameWriter>(filename, frameSize);
+}
+
+std::unique_ptr<SpectrumSink> openSpectrumSink(const std::string& filename, size_t frameSize, OutputFormat format) {
+    if (format == OutputFormat::Binary) {
+        return std::make_unique<BinaryFFTWriter>(filename, frameSize);
+    }
+    return std::make_unique<FFTWriter>(filename, frameSize);
+}
+
+std::unique_ptr<FrameSink> openSignalSink(const std::string& filename, OutputFormat format, size_t channels) {
+    if (format == OutputFormat::Binary) {
+        return std::make_unique<BinaryFrameWriter>(filename, channels);
+    }
+    return std::make_unique<SignalWriter>(filename);
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& filename)
+    : bytes(nullptr), length(0), handle(INVALID_HANDLE_VALUE), mapping(nullptr) {
+    handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(handle, &fileSize);
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) return;
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (bytes == nullptr) {
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(handle);
+        throw std::runtime_error("Could not map file: " + filename);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) UnmapViewOfFile(bytes);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+}
+#else
+MappedFile::MappedFile(const std::string& filename) : bytes(nullptr), length(0) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat file: " + filename);
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length > 0) {
+        void* ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map file: " + filename);
+        }
+        madvise(ptr, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const unsigned char*>(ptr);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) munmap(const_cast<unsigned char*>(bytes), length);
+}
+#endif
+
+Pcm16Source::Pcm16Source(const std::string& filename, size_t numChannels)
+    : file(filename), offset(0), numChannels(numChannels) {}
+
+size_t Pcm16Source::read(float* dst, size_t count) {
+    // Whole sample instants only, a truncated last instant is dropped
+    const size_t available = file.size() / 2 / numChannels * numChannels - offset;
+    const size_t n = std::min(count, available);
+    const unsigned char* p = file.data() + 2 * offset;
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(static_cast<int16_t>(readLE16(p + 2 * i))) / 32768.0f;
+    }
+    offset += n;
+    return n;
+}
+
+WavSource::WavSource(const std::string& filename)
+    : file(filename), samples(nullptr), numSamples(0), offset(0), format(0), bitsPerSample(0), numChannels(0),
+      rate(0) {
+    const unsigned char* p = file.data();
+    const size_t size = file.size();
+    if (size < 12 || std::memcmp(p, "RIFF", 4) != 0 || std::memcmp(p + 8, "WAVE", 4) != 0) {
+        throw std::runtime_error("Not a RIFF/WAVE file: " + filename);
+    }
+
+    bool haveFormat = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint32_t chunkSize = readLE32(p + pos + 4);
+        const unsigned char* chunk = p + pos + 8;
+        const size_t chunkBytes = std::min<size_t>(chunkSize, size - pos - 8);
+
+        if (std::memcmp(p + pos, "fmt ", 4) == 0 && chunkBytes >= 16) {
+            format = readLE16(chunk);
+            numChannels = readLE16(chunk + 2);
+            rate = readLE32(chunk + 4);
+            bitsPerSample = readLE16(chunk + 14);
+            // WAVE_FORMAT_EXTENSIBLE carries the actual format in the first bytes of the sub-format GUID
+            if (format == 0xFFFE && chunkBytes >= 26) {
+                format = readLE16(chunk + 24);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(p + pos, "data", 4) == 0) {
+            if (!haveFormat) {
+                throw std::runtime_error("WAV data chunk before fmt chunk: " + filename);
+            }
+            samples = chunk;
+            break;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (samples == nullptr) {
+        throw std::runtime_error("No data chunk in WAV file: " + filename);
+    }
+    if (numChannels == 0) {
+        throw std::runtime_error("WAV file without channels: " + filename);
+    }
+    if (!((format == 1 && bitsPerSample == 16) || (format == 3 && bitsPerSample == 32))) {
+        throw std::runtime_error("Unsupported WAV sample format (16-bit PCM or 32-bit float expected): " + filename);
+    }
+    // Whole sample instants only, a truncated last instant is dropped
+    const size_t dataBytes = std::min<size_t>(readLE32(samples - 4), size - static_cast<size_t>(samples - p));
+    numSamples = dataBytes / (bitsPerSample / 8) / numChannels * numChannels;
+}
+
+size_t WavSource::read(float* dst, size_t count) {
+    const size_t n = std::min(count, numSamples - offset);
+    if (format == 1) {
+        const unsigned char* p = samples + 2 * offset;
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = static_cast<float>(static_cast<int16_t>(readLE16(p + 2 * i))) / 32768.0f;
+        }
+    } else {
+        const unsigned char* p = samples + 4 * offset;
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits = readLE32(p + 4 * i);
+            std::memcpy(&dst[i], &bits, sizeof(float));
+        }
+    }
+    offset += n;
+    return n;
+}
+
+std::unique_ptr<SampleSource> openSampleSource(const std::string& filename, size_t channels) {
+    std::string ext;
+    const size_t dot = filename.find_last_of('.');
+    if (dot != std::string::npos) {
+        ext = filename.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    }
+    if (ext == ".wav") {
+        return std::make_unique<WavSource>(filename);
+    }
+    if (ext == ".pcm" || ext == ".raw") {
+        return std::make_unique<Pcm16Source>(filename, channels);
+    }
+    return std::make_unique<BinTextSource>(filename);
+}
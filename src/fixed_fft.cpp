@@ -0,0 +1,512 @@
+// Stages are branch-free integer loops compiled once per instruction set through target attributes, like
+// the kernels of fixed_point.cpp: int16_t words vectorize in 16/32-bit lanes, int32_t words in 32/64-bit
+// lanes. All variants compute the same integers.
+#include "fixed_fft.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FFT_X86 1
+#endif
+
+#if defined(__GNUC__)
+#define FFT_INLINE inline __attribute__((always_inline))
+#define FFT_RESTRICT __restrict__
+#else
+#define FFT_INLINE inline
+#define FFT_RESTRICT
+#endif
+
+namespace {
+
+// Products of two words, and the exact sums of a butterfly before they are rounded
+template <typename Word> struct WideOf;
+template <> struct WideOf<int16_t> { using type = int32_t; };
+template <> struct WideOf<int32_t> { using type = int64_t; };
+
+// Headroom each stage needs above the largest input mantissa. A radix-4 output is at most
+// 4 * √2 * |w| < 6 times its largest input part, the split at most 2 + 2√2 |w| < 5 times, where |w| exceeds 1
+// by at most the rounding of the twiddle; a twiddle-free radix-2 output at most 2 times.
+constexpr unsigned kGuardRadix4 = 3;
+constexpr unsigned kGuardRadix2 = 1;
+constexpr unsigned kGuardSplit = 3;
+
+// Right shift by bits, towards minus infinity or to nearest with ties to even: the quotient rounds up when
+// the remainder plus its parity exceeds half. half is never exceeded when bits is 0.
+template <bool Even, typename Wide>
+FFT_INLINE Wide roundShift(Wide v, int bits, Wide low, Wide half) {
+    const Wide q = static_cast<Wide>(v >> bits);
+    if constexpr (!Even) return q;
+    const Wide rem = static_cast<Wide>((v & low) + (q & 1));
+    return static_cast<Wide>(q + (rem > half));
+}
+
+// Block shift of the stage inputs, in words, and rounding of the twiddle products, in wide words
+template <typename Word>
+struct Rounding {
+    using Wide = typename WideOf<Word>::type;
+    int shift;
+    Word low, half;
+    int tw_bits;                        // Twiddle fraction bits
+    Wide tw_low, tw_half;
+};
+
+template <typename Word>
+FFT_INLINE Rounding<Word> makeRounding(int shift, int tw_bits) {
+    using Wide = typename WideOf<Word>::type;
+    return {shift, static_cast<Word>((Wide(1) << shift) - 1),
+            shift > 0 ? static_cast<Word>(Wide(1) << (shift - 1)) : std::numeric_limits<Word>::max(),
+            tw_bits, (Wide(1) << tw_bits) - 1, Wide(1) << (tw_bits - 1)};
+}
+
+template <bool Even, typename Word>
+FFT_INLINE Word scaleIn(Word v, const Rounding<Word>& r) {
+    return static_cast<Word>(roundShift<Even, Word>(v, r.shift, r.low, r.half));
+}
+
+// (ur + i ui) * (wr + i wi), rounded once per part
+template <bool Even, typename Word>
+FFT_INLINE void twiddle(Word ur, Word ui, Word wr, Word wi, const Rounding<Word>& r, Word& yr, Word& yi) {
+    using Wide = typename WideOf<Word>::type;
+    yr = static_cast<Word>(roundShift<Even>(Wide(ur) * wr - Wide(ui) * wi, r.tw_bits, r.tw_low, r.tw_half));
+    yi = static_cast<Word>(roundShift<Even>(Wide(ur) * wi + Wide(ui) * wr, r.tw_bits, r.tw_low, r.tw_half));
+}
+
+// Has the bit length of |v| (of -v - 1 for negative v); OR-ing them keeps that of the largest
+template <typename Word>
+FFT_INLINE Word magnitude(Word v) {
+    return static_cast<Word>(v ^ (v >> (8 * sizeof(Word) - 1)));
+}
+
+// Sum and difference of two words, which the guard bits keep inside the word
+template <typename Word>
+FFT_INLINE Word add(Word a, Word b) { return static_cast<Word>(a + b); }
+template <typename Word>
+FFT_INLINE Word sub(Word a, Word b) { return static_cast<Word>(a - b); }
+
+// Rounds in * scale to a word, saturating. Adding 1.5 * 2^52 rounds a double to an integer, ties to even,
+// in every SIMD width; floor steps back where that rounded up.
+template <bool Even, typename Word, typename T>
+FFT_INLINE void quantizeBody(const T* FFT_RESTRICT in, size_t count, double scale, Word* FFT_RESTRICT out) {
+    constexpr double kRound = 6755399441055744.0;
+    constexpr double lo = std::numeric_limits<Word>::min();
+    constexpr double hi = std::numeric_limits<Word>::max();
+    for (size_t i = 0; i < count; i++){
+        double v = static_cast<double>(in[i]) * scale;
+        v = v > hi ? hi : (v < lo ? lo : v);
+        v = (v == v) ? v : 0.0;
+        double r = (v + kRound) - kRound;
+        if constexpr (!Even) r -= (r > v) ? 1.0 : 0.0;
+        out[i] = static_cast<Word>(static_cast<int32_t>(r));
+    }
+}
+
+// One decimation-in-frequency radix-4 butterfly of the Stockham FFT: inputs i, i + step, i + 2 step, i + 3 step,
+// outputs o, o + out_step, o + 2 out_step, o + 3 out_step
+template <bool Even, typename Word>
+FFT_INLINE void butterfly4(const Word* FFT_RESTRICT xr, const Word* FFT_RESTRICT xi, size_t i, size_t step,
+                           Word* FFT_RESTRICT yr, Word* FFT_RESTRICT yi, size_t o, size_t out_step,
+                           const Word* w, size_t w_step, const Rounding<Word>& r, Word& bits) {
+    const Word ar = scaleIn<Even>(xr[i], r), ai = scaleIn<Even>(xi[i], r);
+    const Word br = scaleIn<Even>(xr[i + step], r), bi = scaleIn<Even>(xi[i + step], r);
+    const Word cr = scaleIn<Even>(xr[i + 2 * step], r), ci = scaleIn<Even>(xi[i + 2 * step], r);
+    const Word dr = scaleIn<Even>(xr[i + 3 * step], r), di = scaleIn<Even>(xi[i + 3 * step], r);
+    const Word apc_r = add(ar, cr), apc_i = add(ai, ci), amc_r = sub(ar, cr), amc_i = sub(ai, ci);
+    const Word bpd_r = add(br, dr), bpd_i = add(bi, di), bmd_r = sub(br, dr), bmd_i = sub(bi, di);
+    const Word y0r = add(apc_r, bpd_r), y0i = add(apc_i, bpd_i);
+    Word y1r, y1i, y2r, y2i, y3r, y3i;
+    // -j (b - d) and +j (b - d) around a - c
+    twiddle<Even>(add(amc_r, bmd_i), sub(amc_i, bmd_r), w[0], w[w_step], r, y1r, y1i);
+    twiddle<Even>(sub(apc_r, bpd_r), sub(apc_i, bpd_i), w[2 * w_step], w[3 * w_step], r, y2r, y2i);
+    twiddle<Even>(sub(amc_r, bmd_i), add(amc_i, bmd_r), w[4 * w_step], w[5 * w_step], r, y3r, y3i);
+    yr[o] = y0r; yi[o] = y0i;
+    yr[o + out_step] = y1r; yi[o + out_step] = y1i;
+    yr[o + 2 * out_step] = y2r; yi[o + 2 * out_step] = y2i;
+    yr[o + 3 * out_step] = y3r; yi[o + 3 * out_step] = y3i;
+    bits |= magnitude(y0r) | magnitude(y0i) | magnitude(y1r) | magnitude(y1i) |
+            magnitude(y2r) | magnitude(y2i) | magnitude(y3r) | magnitude(y3i);
+}
+
+// Stage of sub-length n and stride s, x to y. w holds the twiddles of the stage in 6 rows of n/4: real and
+// imaginary parts of w^p, w^2p and w^3p. Returns the OR of the output magnitudes.
+template <bool Even, typename Word>
+FFT_INLINE Word radix4Body(size_t n, size_t s, const Word* FFT_RESTRICT xr, const Word* FFT_RESTRICT xi,
+                           Word* FFT_RESTRICT yr, Word* FFT_RESTRICT yi, const Word* FFT_RESTRICT w,
+                           int tw_bits, int shift) {
+    const Rounding<Word> r = makeRounding<Word>(shift, tw_bits);
+    const size_t m = n / 4;
+    Word bits = 0;
+    if (s == 1) {
+        // First stage: p runs over contiguous inputs
+#pragma GCC ivdep
+        for (size_t p = 0; p < m; p++){
+            butterfly4<Even>(xr, xi, p, m, yr, yi, 4 * p, 1, &w[p], m, r, bits);
+        }
+        return bits;
+    }
+    for (size_t p = 0; p < m; p++){
+        const Word wp[6] = {w[p], w[m + p], w[2 * m + p], w[3 * m + p], w[4 * m + p], w[5 * m + p]};
+#pragma GCC ivdep
+        for (size_t q = 0; q < s; q++){
+            butterfly4<Even>(xr, xi, q + s * p, s * m, yr, yi, q + s * 4 * p, s, wp, 1, r, bits);
+        }
+    }
+    return bits;
+}
+
+// Last stage when log2(N/2) is odd: sub-length 2, stride s, twiddles all 1
+template <bool Even, typename Word>
+FFT_INLINE Word radix2Body(size_t s, const Word* FFT_RESTRICT xr, const Word* FFT_RESTRICT xi, Word* FFT_RESTRICT yr,
+                           Word* FFT_RESTRICT yi, int shift) {
+    const Rounding<Word> r = makeRounding<Word>(shift, 1);
+    Word bits = 0;
+    for (size_t q = 0; q < s; q++){
+        const Word ar = scaleIn<Even>(xr[q], r), ai = scaleIn<Even>(xi[q], r);
+        const Word br = scaleIn<Even>(xr[q + s], r), bi = scaleIn<Even>(xi[q + s], r);
+        const Word y0r = add(ar, br), y0i = add(ai, bi);
+        const Word y1r = sub(ar, br), y1i = sub(ai, bi);
+        yr[q] = y0r; yi[q] = y0i;
+        yr[q + s] = y1r; yi[q + s] = y1i;
+        bits |= magnitude(y0r) | magnitude(y0i) | magnitude(y1r) | magnitude(y1i);
+    }
+    return bits;
+}
+
+// N/2 + 1 real-FFT bins from the FFT Z of z[n] = x[2n] + i x[2n + 1], interleaved into out:
+// 2 X[k] = A + W^k B with A = Z[k] + conj(Z[M - k]) and B = -i (Z[k] - conj(Z[M - k])). The factor 2 goes
+// into the exponent; DC and Nyquist need no twiddle.
+template <bool Even, typename Word>
+FFT_INLINE void forwardSplitBody(size_t half, const Word* FFT_RESTRICT zr, const Word* FFT_RESTRICT zi, const Word* w,
+                                 int tw_bits, int shift, Word* FFT_RESTRICT out) {
+    const Rounding<Word> r = makeRounding<Word>(shift, tw_bits);
+    const Word r0 = scaleIn<Even>(zr[0], r), i0 = scaleIn<Even>(zi[0], r);
+    out[0] = static_cast<Word>(2 * add(r0, i0));
+    out[1] = 0;
+    out[2 * half] = static_cast<Word>(2 * sub(r0, i0));
+    out[2 * half + 1] = 0;
+    for (size_t k = 1; k < half; k++){
+        const Word a = scaleIn<Even>(zr[k], r), b = scaleIn<Even>(zr[half - k], r);
+        const Word c = scaleIn<Even>(zi[k], r), d = scaleIn<Even>(zi[half - k], r);
+        Word tr, ti;
+        twiddle<Even>(add(c, d), sub(b, a), w[2 * k], w[2 * k + 1], r, tr, ti);
+        out[2 * k] = add(add(a, b), tr);
+        out[2 * k + 1] = add(sub(c, d), ti);
+    }
+}
+
+// Inverse of the split: Z[k] = A + i W^-k B with A = X[k] + conj(X[M - k]) and B = X[k] - conj(X[M - k]),
+// so that the FFT of M points of Z gives N (x[2n] + i x[2n + 1]). Z is stored conjugated, the inverse FFT
+// running as the conjugate of the forward one. Returns the OR of the output magnitudes.
+template <bool Even, typename Word>
+FFT_INLINE Word inverseSplitBody(size_t half, const Word* FFT_RESTRICT xr, const Word* FFT_RESTRICT xi, const Word* w,
+                                 int tw_bits, int shift, Word* FFT_RESTRICT zr, Word* FFT_RESTRICT zi) {
+    const Rounding<Word> r = makeRounding<Word>(shift, tw_bits);
+    const Word dc = scaleIn<Even>(xr[0], r), nyquist = scaleIn<Even>(xr[half], r);
+    zr[0] = add(dc, nyquist);
+    zi[0] = sub(nyquist, dc);
+    Word bits = magnitude(zr[0]) | magnitude(zi[0]);
+    for (size_t k = 1; k < half; k++){
+        const Word a = scaleIn<Even>(xr[k], r), b = scaleIn<Even>(xi[k], r);
+        const Word c = scaleIn<Even>(xr[half - k], r), d = scaleIn<Even>(xi[half - k], r);
+        Word tr, ti;
+        twiddle<Even>(sub(a, c), add(b, d), w[2 * k], static_cast<Word>(-w[2 * k + 1]), r, tr, ti);
+        const Word yr = sub(add(a, c), ti);
+        const Word yi = sub(sub(d, b), tr);
+        zr[k] = yr;
+        zi[k] = yi;
+        bits |= magnitude(yr) | magnitude(yi);
+    }
+    return bits;
+}
+
+// Bit length of the largest magnitude of a block whose magnitudes OR to bits, minus the length it may have
+// with guard bits left above it: positive when the block must be shifted right
+template <typename Word>
+int excessBits(Word bits, unsigned guard) {
+    int length = 0;
+    for (auto v = static_cast<std::make_unsigned_t<Word>>(bits); v != 0; v >>= 1) length++;
+    return length - (static_cast<int>(8 * sizeof(Word)) - 1 - static_cast<int>(guard));
+}
+
+// Right shift of the inputs of a stage, added to exponent. Blocks only grow in magnitude inside the
+// transform, so only its input is normalized up.
+template <typename Word>
+int stageShift(Word bits, unsigned guard, int& exponent) {
+    const int shift = std::max(0, excessBits(bits, guard));
+    exponent += shift;
+    return shift;
+}
+
+// Exact left shift of a block by the headroom above its guard bits, taken off exponent. Returns the OR of
+// the shifted magnitudes.
+template <typename Word>
+int headroom(Word bits, unsigned guard, int& exponent) {
+    const int shift = std::max(0, -excessBits(bits, guard));
+    exponent -= shift;
+    return shift;
+}
+
+template <typename Word>
+Word shiftUp(Word* words, size_t count, int shift) {
+    const Word factor = static_cast<Word>(Word(1) << shift);
+    Word bits = 0;
+    for (size_t i = 0; i < count; i++){
+        words[i] = static_cast<Word>(words[i] * factor);
+        bits |= magnitude(words[i]);
+    }
+    return bits;
+}
+
+// Rounded to nearest whatever the rounding of the transform, 1.0 saturating
+template <typename Word>
+Word quantizeTwiddle(double v, int tw_bits) {
+    const double limit = std::ldexp(1.0, tw_bits) - 1;
+    return static_cast<Word>(std::clamp(std::nearbyint(std::ldexp(v, tw_bits)), -limit, limit));
+}
+
+} // namespace
+
+// One instruction set's build of every stage, for one word and rounding
+template <typename Word>
+struct FixedFFTKernels {
+    void (*quantize_double)(const double* in, size_t count, double scale, Word* out);
+    void (*quantize_float)(const float* in, size_t count, double scale, Word* out);
+    Word (*radix4)(size_t n, size_t s, const Word* xr, const Word* xi, Word* yr, Word* yi, const Word* w,
+                   int tw_bits, int shift);
+    Word (*radix2)(size_t s, const Word* xr, const Word* xi, Word* yr, Word* yi, int shift);
+    void (*forward_split)(size_t half, const Word* zr, const Word* zi, const Word* w, int tw_bits,
+                          int shift, Word* out);
+    Word (*inverse_split)(size_t half, const Word* xr, const Word* xi, const Word* w, int tw_bits, int shift,
+                          Word* zr, Word* zi);
+};
+
+#define FIXED_FFT_KERNELS(NAME, ATTRIBUTES)                                                                     \
+    namespace NAME {                                                                                            \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES void quantizeDouble(const double* in, size_t count, double scale, Word* out) {                   \
+        quantizeBody<Even>(in, count, scale, out);                                                              \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES void quantizeFloat(const float* in, size_t count, double scale, Word* out) {                     \
+        quantizeBody<Even>(in, count, scale, out);                                                              \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES Word radix4(size_t n, size_t s, const Word* xr, const Word* xi, Word* yr, Word* yi,             \
+                           const Word* w, int tw_bits, int shift) {                                      \
+        return radix4Body<Even>(n, s, xr, xi, yr, yi, w, tw_bits, shift);                                      \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES Word radix2(size_t s, const Word* xr, const Word* xi, Word* yr, Word* yi, int shift) {    \
+        return radix2Body<Even>(s, xr, xi, yr, yi, shift);                                                     \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES void forwardSplit(size_t half, const Word* zr, const Word* zi, const Word* w, int tw_bits,       \
+                                 int shift, Word* out) {                                                 \
+        forwardSplitBody<Even>(half, zr, zi, w, tw_bits, shift, out);                                           \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    ATTRIBUTES Word inverseSplit(size_t half, const Word* xr, const Word* xi, const Word* w, int tw_bits,      \
+                                 int shift, Word* zr, Word* zi) {                                               \
+        return inverseSplitBody<Even>(half, xr, xi, w, tw_bits, shift, zr, zi);                                 \
+    }                                                                                                           \
+    template <bool Even, typename Word>                                                                         \
+    constexpr FixedFFTKernels<Word> forMode() {                                                                 \
+        return {quantizeDouble<Even, Word>, quantizeFloat<Even, Word>, radix4<Even, Word>, radix2<Even, Word>,  \
+                forwardSplit<Even, Word>, inverseSplit<Even, Word>};                                            \
+    }                                                                                                           \
+    template <typename Word>                                                                                    \
+    const FixedFFTKernels<Word> kernels[2] = {forMode<false, Word>(), forMode<true, Word>()};                   \
+    }
+
+namespace {
+FIXED_FFT_KERNELS(fft_baseline, )
+#ifdef FFT_X86
+FIXED_FFT_KERNELS(fft_avx2, __attribute__((target("avx2"))))
+FIXED_FFT_KERNELS(fft_avx512, __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl,prefer-vector-width=512"))))
+#endif
+} // namespace
+
+template <typename Word>
+static const FixedFFTKernels<Word>* fixedFFTKernels(SimdLevel level, FixedRounding rounding) {
+    const size_t mode = (rounding == FixedRounding::Trunc) ? 0 : 1;
+#ifdef FFT_X86
+    // 16-bit lanes need AVX512BW, 64-bit multiplies AVX512DQ; without them the AVX2 build is used
+    if (level == SimdLevel::AVX512 && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) {
+        return &fft_avx512::kernels<Word>[mode];
+    }
+    if (level == SimdLevel::AVX512 || level == SimdLevel::AVX2) return &fft_avx2::kernels<Word>[mode];
+#endif
+    (void)level;
+    return &fft_baseline::kernels<Word>[mode];
+}
+
+void FixedFFTConfig::validate() const {
+    if (word_bits != 16 && word_bits != 32) {
+        throw std::invalid_argument("Unsupported fixed-point FFT word length, expected 16 or 32 bits: " +
+                                    std::to_string(word_bits));
+    }
+    if (twiddle_bits < 2 || twiddle_bits > word_bits) {
+        throw std::invalid_argument("Unsupported fixed-point FFT twiddle length, expected 2 to " +
+                                    std::to_string(word_bits) + " bits: " + std::to_string(twiddle_bits));
+    }
+}
+
+
+// Twiddles of the radix-4 stages, n = M, M/4, ... down to 4: rows of the real and imaginary parts of w^p,
+// w^2p and w^3p for p < n/4, with w = e^(-2πi/n). Then those of the split: W^k for k <= M with W = e^(-2πi/N).
+template <typename Word>
+BasicFixedPointFFT<Word>::BasicFixedPointFFT(size_t frame_size_param, const FixedFFTConfig& config_param, SimdLevel simd)
+: frame_size(frame_size_param), half(frame_size_param / 2), config((config_param.validate(), config_param)),
+re(half), im(half), re_tmp(half), im_tmp(half), split_twiddles(2 * (half + 1)), samples(frame_size_param),
+spectrum(2 * (half + 1)), planar(2 * (half + 1)), kernels(fixedFFTKernels<Word>(simd, config_param.rounding)) {
+    if (frame_size < 4 || (frame_size & (frame_size - 1)) != 0) {
+        throw std::invalid_argument("The fixed-point FFT needs a power of two frame size from 4: " +
+                                    std::to_string(frame_size));
+    }
+    if (config.word_bits != 8 * sizeof(Word)) {
+        throw std::invalid_argument("Fixed-point FFT word length does not match its word type");
+    }
+    const int tw_bits = static_cast<int>(config.twiddle_bits) - 1;
+    const double two_pi = 2 * std::acos(-1.0);
+    for (size_t n = half; n >= 4; n /= 4) {
+        for (size_t j = 1; j <= 3; j++){
+            for (bool imaginary : {false, true}) {
+                for (size_t p = 0; p < n / 4; p++){
+                    const double angle = -two_pi * static_cast<double>(j * p) / static_cast<double>(n);
+                    twiddles.push_back(quantizeTwiddle<Word>(imaginary ? std::sin(angle) : std::cos(angle), tw_bits));
+                }
+            }
+        }
+    }
+    for (size_t k = 0; k <= half; k++){
+        const double angle = -two_pi * static_cast<double>(k) / static_cast<double>(frame_size);
+        split_twiddles[2 * k] = quantizeTwiddle<Word>(std::cos(angle), tw_bits);
+        split_twiddles[2 * k + 1] = quantizeTwiddle<Word>(std::sin(angle), tw_bits);
+    }
+}
+
+template <typename Word>
+int BasicFixedPointFFT<Word>::complexFFT(Word& bits, int exponent) {
+    const int tw_bits = static_cast<int>(config.twiddle_bits) - 1;
+    const Word* w = twiddles.data();
+    size_t n = half, s = 1;
+    for (; n >= 4; n /= 4, s *= 4) {
+        const int shift = stageShift(bits, kGuardRadix4, exponent);
+        bits = kernels->radix4(n, s, re.data(), im.data(), re_tmp.data(), im_tmp.data(), w, tw_bits, shift);
+        w += 6 * (n / 4);
+        std::swap(re, re_tmp);
+        std::swap(im, im_tmp);
+    }
+    if (n == 2) {
+        const int shift = stageShift(bits, kGuardRadix2, exponent);
+        bits = kernels->radix2(s, re.data(), im.data(), re_tmp.data(), im_tmp.data(), shift);
+        std::swap(re, re_tmp);
+        std::swap(im, im_tmp);
+    }
+    return exponent;
+}
+
+template <typename Word>
+int BasicFixedPointFFT<Word>::forward(const Word* in, Word* out) {
+    Word bits = 0;
+    for (size_t n = 0; n < half; n++){
+        re[n] = in[2 * n];
+        im[n] = in[2 * n + 1];
+        bits |= magnitude(re[n]) | magnitude(im[n]);
+    }
+    int exponent = 1 - static_cast<int>(config.word_bits);
+    const unsigned guard = (half >= 4) ? kGuardRadix4 : kGuardRadix2;
+    const int up = headroom(bits, guard, exponent);
+    if (up > 0) bits = shiftUp(re.data(), half, up) | shiftUp(im.data(), half, up);
+    exponent = complexFFT(bits, exponent);
+    const int shift = stageShift(bits, kGuardSplit, exponent);
+    kernels->forward_split(half, re.data(), im.data(), split_twiddles.data(), static_cast<int>(config.twiddle_bits) - 1,
+                           shift, out);
+    return exponent - 1;
+}
+
+template <typename Word>
+int BasicFixedPointFFT<Word>::inverse(const Word* in, int exponent, Word* out) {
+    // Real parts, then imaginary ones. Those of DC and Nyquist are ignored, zeroing them keeps them out of
+    // the normalization.
+    Word* xr = planar.data();
+    Word* xi = planar.data() + half + 1;
+    for (size_t k = 0; k <= half; k++){
+        xr[k] = in[2 * k];
+        xi[k] = in[2 * k + 1];
+    }
+    xi[0] = 0;
+    xi[half] = 0;
+    Word bits = 0;
+    for (size_t i = 0; i < planar.size(); i++){
+        bits |= magnitude(planar[i]);
+    }
+    const int up = headroom(bits, kGuardSplit, exponent);
+    if (up > 0) bits = shiftUp(planar.data(), planar.size(), up);
+    const int shift = stageShift(bits, kGuardSplit, exponent);
+    bits = kernels->inverse_split(half, xr, xi, split_twiddles.data(), static_cast<int>(config.twiddle_bits) - 1,
+                                  shift, re.data(), im.data());
+    exponent = complexFFT(bits, exponent);
+    // Conjugate back
+    for (size_t n = 0; n < half; n++){
+        out[2 * n] = re[n];
+        out[2 * n + 1] = static_cast<Word>(-im[n]);
+    }
+    return exponent;
+}
+
+template <typename Word>
+template <typename T>
+void BasicFixedPointFFT<Word>::forward(const T* in, std::complex<T>* out) {
+    const double scale = std::ldexp(1.0, static_cast<int>(config.word_bits) - 1);
+    if constexpr (std::is_same<T, double>::value) kernels->quantize_double(in, frame_size, scale, samples.data());
+    else kernels->quantize_float(in, frame_size, scale, samples.data());
+    const double lsb = std::ldexp(1.0, forward(samples.data(), spectrum.data()));
+    for (size_t k = 0; k <= half; k++){
+        out[k] = std::complex<T>(static_cast<T>(spectrum[2 * k] * lsb), static_cast<T>(spectrum[2 * k + 1] * lsb));
+    }
+}
+
+// The spectrum shares the exponent that puts its largest part just below the guard bits of the split.
+// An all-zero or non-finite spectrum gives zeros.
+template <typename Word>
+template <typename T>
+void BasicFixedPointFFT<Word>::inverse(const std::complex<T>* in, T* out) {
+    double largest = std::max(std::abs(static_cast<double>(in[0].real())), std::abs(static_cast<double>(in[half].real())));
+    for (size_t k = 1; k < half; k++){
+        largest = std::max({largest, std::abs(static_cast<double>(in[k].real())), std::abs(static_cast<double>(in[k].imag()))});
+    }
+    if (!(largest > 0) || !std::isfinite(largest)) {
+        std::fill(out, out + frame_size, T(0));
+        return;
+    }
+    int largest_exponent;
+    std::frexp(largest, &largest_exponent);
+    const int exponent = largest_exponent - (static_cast<int>(config.word_bits) - 1 - static_cast<int>(kGuardSplit));
+    const double scale = std::ldexp(1.0, -exponent);
+    if constexpr (std::is_same<T, double>::value) {
+        kernels->quantize_double(reinterpret_cast<const double*>(in), 2 * (half + 1), scale, spectrum.data());
+    } else {
+        kernels->quantize_float(reinterpret_cast<const float*>(in), 2 * (half + 1), scale, spectrum.data());
+    }
+    const double lsb = std::ldexp(1.0, inverse(spectrum.data(), exponent, samples.data()));
+    for (size_t n = 0; n < frame_size; n++){
+        out[n] = static_cast<T>(samples[n] * lsb);
+    }
+}
+
+template class BasicFixedPointFFT<int16_t>;
+template class BasicFixedPointFFT<int32_t>;
+template void BasicFixedPointFFT<int16_t>::forward<double>(const double*, std::complex<double>*);
+template void BasicFixedPointFFT<int16_t>::forward<float>(const float*, std::complex<float>*);
+template void BasicFixedPointFFT<int16_t>::inverse<double>(const std::complex<double>*, double*);
+template void BasicFixedPointFFT<int16_t>::inverse<float>(const std::complex<float>*, float*);
+template void BasicFixedPointFFT<int32_t>::forward<double>(const double*, std::complex<double>*);
+template void BasicFixedPointFFT<int32_t>::forward<float>(const float*, std::complex<float>*);
+template void BasicFixedPointFFT<int32_t>::inverse<double>(const std::complex<double>*, double*);
+template void BasicFixedPointFFT<int32_t>::inverse<float>(const std::complex<float>*, float*);
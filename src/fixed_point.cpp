@@ -0,0 +1,469 @@
+// Every kernel is branch-free integer arithmetic on int64_t lanes, compiled once per instruction set
+// through target attributes, so the vectorizer turns it into AVX2 or AVX-512 integer code (NEON on
+// AArch64, where it is the baseline). All variants compute the same exact integers.
+#include "fixed_point.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FIXED_X86 1
+#endif
+
+#if defined(__GNUC__)
+#define FIXED_INLINE inline __attribute__((always_inline))
+#else
+#define FIXED_INLINE inline
+#endif
+
+namespace {
+
+// Rounding and overflow of a destination format, hoisted out of the loops
+struct Fit {
+    int64_t lo;
+    int64_t hi;
+    int64_t mask;                       // 2^total_bits - 1
+    int64_t wrap;                       // 1 wraps, 0 saturates
+    int64_t half_even;                  // 1 rounds half to even, 0 floors
+};
+
+// Right shift by bits with the masks its rounding needs
+struct Shift {
+    int bits;
+    int64_t low;                        // Bits shifted out
+    int64_t half;                       // Weight of half an output LSB, never reached when bits is 0
+};
+
+// Kernels are built for each combination of rounding and overflow, known at compile time when every
+// format of a configuration uses the same ones, read from Fit as 0/1 masks otherwise
+enum KernelMode : unsigned { FloorSaturate, FloorWrap, EvenSaturate, EvenWrap, MixedModes, kKernelModes };
+
+template <unsigned M> constexpr bool kWrap = (M == FloorWrap || M == EvenWrap);
+template <unsigned M> constexpr bool kHalfEven = (M == EvenSaturate || M == EvenWrap);
+
+Fit makeFit(const FixedPointFormat& format) {
+    return {format.minValue(), format.maxValue(), (int64_t(1) << format.total_bits) - 1,
+            format.overflow == FixedOverflow::Wrap ? 1 : 0, format.rounding == FixedRounding::Trunc ? 0 : 1};
+}
+
+Shift makeShift(int bits) {
+    return {bits, (int64_t(1) << bits) - 1, bits > 0 ? int64_t(1) << (bits - 1) : std::numeric_limits<int64_t>::max()};
+}
+
+unsigned kernelMode(const FixedPointConfig& config) {
+    const FixedRounding rounding = config.data.rounding;
+    const FixedOverflow overflow = config.data.overflow;
+    for (const FixedPointFormat* format : {&config.power, &config.ratio, &config.gain, &config.coef}) {
+        if (format->rounding != rounding || format->overflow != overflow) return MixedModes;
+    }
+    const bool wrap = (overflow == FixedOverflow::Wrap);
+    if (rounding == FixedRounding::Trunc) return wrap ? FloorWrap : FloorSaturate;
+    return wrap ? EvenWrap : EvenSaturate;
+}
+
+template <unsigned M>
+FIXED_INLINE int64_t fitValue(int64_t v, const Fit& f) {
+    const int64_t saturated = v < f.lo ? f.lo : (v > f.hi ? f.hi : v);
+    const int64_t wrapped = ((v - f.lo) & f.mask) + f.lo;
+    if constexpr (M == MixedModes) return f.wrap ? wrapped : saturated;
+    else if constexpr (kWrap<M>) return wrapped;
+    else return saturated;
+}
+
+// v * 2^bits, through unsigned so that negative words shift too
+FIXED_INLINE int64_t shiftLeft(int32_t v, int bits) {
+    return static_cast<int64_t>(static_cast<uint64_t>(static_cast<int64_t>(v)) << bits);
+}
+
+// v * 2^-bits rounded towards minus infinity, or half to even
+template <unsigned M>
+FIXED_INLINE int64_t shiftRound(int64_t v, const Shift& s, const Fit& f) {
+    const int64_t q = v >> s.bits;
+    if constexpr (M != MixedModes && !kHalfEven<M>) return q;
+    const int64_t rem = v & s.low;
+    const int64_t up = (rem > s.half) | ((rem == s.half) & q);
+    if constexpr (M == MixedModes) return q + (up & f.half_even);
+    else return q + up;
+}
+
+// n / d rounded and fitted into f, exact for |n| < 2^62 and |d| < 2^33. One double reciprocal gives a
+// quotient within a few units of the exact one, and the small remainder it leaves is corrected with the same
+// reciprocal, then by at most one unit either way, like the correction steps of a hardware divider. When the
+// destination saturates only quotients below 2^32 survive, which the reciprocal already gets within one unit
+// of, so the first correction is skipped. A zero divisor saturates to the sign of n.
+template <unsigned M>
+FIXED_INLINE int64_t divideRound(int64_t n, int64_t d, const Fit& f) {
+    // Branch-free |d| and the matching sign of n, the vectorizer gives up on selects around a division
+    const int64_t sign = d >> 63;
+    n = (n ^ sign) - sign;
+    d = (d ^ sign) - sign;
+    const int64_t zero = (d == 0) ? 1 : 0;
+    const int64_t den = d + zero;
+    const double inverse = 1.0 / static_cast<double>(den);
+    int64_t q = static_cast<int64_t>(static_cast<double>(n) * inverse);
+    int64_t r = n - q * den;
+    if constexpr (M == MixedModes || kWrap<M>) {
+        const int64_t correction = static_cast<int64_t>(static_cast<double>(r) * inverse);
+        q += correction;
+        r -= correction * den;
+    }
+    // Truncated towards zero from within one unit, so up to two units above the floor or one below: step
+    // to it, so that 0 <= r < den
+    for (int step = 0; step < 2; step++){
+        const int64_t below = r >> 63;
+        q += below;
+        r += below & den;
+    }
+    const int64_t above = (r >= den) ? 1 : 0;
+    q += above;
+    r -= (-above) & den;
+    if constexpr (M == MixedModes || kHalfEven<M>) {
+        const int64_t up = (2 * r > den) | ((2 * r == den) & q);
+        q += (M == MixedModes) ? (up & f.half_even) : up;
+    }
+    const int64_t infinite = n > 0 ? f.hi : (n < 0 ? f.lo : 0);
+    const int64_t select = -zero;
+    return (infinite & select) | (fitValue<M>(q, f) & ~select);
+}
+
+// value * 2^frac_bits rounded and fitted, as FixedPointValue does on the double value
+template <unsigned M, typename T>
+FIXED_INLINE int64_t quantizeValue(T value, double scale, const Fit& f) {
+    constexpr double kLimit = 4611686018427387904.0;           // 2^62, keeps the conversion defined
+    const double scaled = static_cast<double>(value) * scale;
+    double r;
+    if constexpr (M == MixedModes) r = f.half_even ? std::nearbyint(scaled) : std::floor(scaled);
+    else if constexpr (kHalfEven<M>) r = std::nearbyint(scaled);   // Round to nearest even, the default mode
+    else r = std::floor(scaled);
+    r = (r == r) ? r : 0.0;
+    r = r > kLimit ? kLimit : (r < -kLimit ? -kLimit : r);
+    return fitValue<M>(static_cast<int64_t>(r), f);
+}
+
+template <unsigned M, typename T>
+FIXED_INLINE void quantizeBody(const T* in, size_t count, double scale, const Fit& f, int32_t* out) {
+    for (size_t i = 0; i < count; i++){
+        out[i] = static_cast<int32_t>(quantizeValue<M>(in[i], scale, f));
+    }
+}
+
+// |X|² of interleaved parts at 2 * data fraction bits, into the power format. The sum of two squares
+// reaches 2^63, so it is formed unsigned; power fraction bits never exceed twice the data ones.
+template <unsigned M>
+FIXED_INLINE void powerBody(const int32_t* X, size_t num_bins, const Shift& s, const Fit& f, int32_t* psd) {
+    const uint64_t hi = static_cast<uint64_t>(f.hi);
+    const uint64_t half = static_cast<uint64_t>(s.half);
+    for (size_t k = 0; k < num_bins; k++){
+        const int64_t re = X[2 * k];
+        const int64_t im = X[2 * k + 1];
+        const uint64_t sum = static_cast<uint64_t>(re * re) + static_cast<uint64_t>(im * im);
+        uint64_t v = sum >> s.bits;
+        if constexpr (M == MixedModes || kHalfEven<M>) {
+            const uint64_t rem = sum & static_cast<uint64_t>(s.low);
+            const uint64_t up = (rem > half) | ((rem == half) & v);
+            v += (M == MixedModes) ? (up & static_cast<uint64_t>(f.half_even)) : up;
+        }
+        const uint64_t saturated = v > hi ? hi : v;
+        const uint64_t wrapped = ((v - static_cast<uint64_t>(f.lo)) & static_cast<uint64_t>(f.mask)) + static_cast<uint64_t>(f.lo);
+        uint64_t fitted;
+        if constexpr (M == MixedModes) fitted = f.wrap ? wrapped : saturated;
+        else fitted = kWrap<M> ? wrapped : saturated;
+        psd[k] = static_cast<int32_t>(static_cast<int64_t>(fitted));
+    }
+}
+
+// Words are int32_t so that their products are widening 32x32->64 bit multiplies
+struct NoiseArgs {
+    int32_t alpha, one_minus_alpha, bias;
+    Shift coef_shift;                   // From coefficient times power fraction bits back to power
+    Fit power;
+};
+
+// Smoothing, running minimum and bias compensation of NoiseEstimator::updateBins(). Two passes, as one
+// loop with both rounding chains is beyond GCC's vectorizer.
+template <unsigned M>
+FIXED_INLINE void noiseBody(size_t num_bins, const int32_t* psd, int32_t* smoothed, int32_t* row, int32_t* prefix,
+                            const int32_t* suffix, bool block_start, int32_t* noise, const NoiseArgs& args) {
+    const NoiseArgs a = args;                   // Local copy, provably not aliased by the stores
+    for (size_t i = 0; i < num_bins; i++){
+        const int64_t acc = int64_t(a.alpha) * smoothed[i] + int64_t(a.one_minus_alpha) * psd[i];
+        const int32_t s = static_cast<int32_t>(fitValue<M>(shiftRound<M>(acc, a.coef_shift, a.power), a.power));
+        smoothed[i] = s;
+        row[i] = s;
+    }
+    const int32_t restart = block_start ? 1 : 0;
+    for (size_t i = 0; i < num_bins; i++){
+        const int32_t s = row[i];
+        const int32_t p = (restart | (s < prefix[i])) ? s : prefix[i];
+        prefix[i] = p;
+        const int32_t min_psd = std::min(suffix[i], p);
+        noise[i] = static_cast<int32_t>(fitValue<M>(shiftRound<M>(int64_t(a.bias) * min_psd, a.coef_shift, a.power), a.power));
+    }
+}
+
+FIXED_INLINE void suffixMinBody(size_t num_bins, const int32_t* next, int32_t* cur) {
+    for (size_t i = 0; i < num_bins; i++){
+        cur[i] = std::min(next[i], cur[i]);
+    }
+}
+
+struct WienerArgs {
+    int32_t alpha_w, one_minus_alpha_w, alpha_snr, one_minus_alpha_snr;
+    int32_t one, xi_floor;
+    int ratio_shift;                    // Ratio fraction bits, numerator scale of |X|²/|Ŵ|²
+    int gain_shift_up;                  // Gain fraction bits, numerator scale of ξ/(1+ξ)
+    Shift coef_shift;                   // Coefficient times ratio back to ratio
+    Shift gain_shift;                   // Data times gain back to data
+    Fit data, ratio, gain;
+};
+
+// Decision-directed gain of wienerGainScalar(), each operation rounded into its destination format. In
+// three passes over the bins, small enough for GCC's vectorizer: ξ, the gain into gain, and X * gain.
+template <unsigned M>
+FIXED_INLINE void wienerBody(size_t num_bins, const int32_t* X, const int32_t* psd, const int32_t* noise,
+                             int32_t* p_xi, int32_t* p_SNR, int32_t* gain, int32_t* out, const WienerArgs& args) {
+    const WienerArgs a = args;
+    for (size_t k = 0; k < num_bins; k++){
+        const int32_t ratio = static_cast<int32_t>(divideRound<M>(shiftLeft(psd[k], a.ratio_shift), noise[k], a.ratio));
+        const int32_t snr = static_cast<int32_t>(fitValue<M>(shiftRound<M>(int64_t(a.alpha_snr) * p_SNR[k] +
+                                                                           int64_t(a.one_minus_alpha_snr) * ratio,
+                                                                           a.coef_shift, a.ratio), a.ratio));
+        const int32_t excess = std::max(static_cast<int32_t>(fitValue<M>(int64_t(snr) - a.one, a.ratio)), a.xi_floor);
+        p_xi[k] = static_cast<int32_t>(fitValue<M>(shiftRound<M>(int64_t(a.alpha_w) * p_xi[k] +
+                                                                 int64_t(a.one_minus_alpha_w) * excess,
+                                                                 a.coef_shift, a.ratio), a.ratio));
+        p_SNR[k] = snr;
+    }
+    for (size_t k = 0; k < num_bins; k++){
+        const int32_t xi = p_xi[k];
+        gain[k] = static_cast<int32_t>(divideRound<M>(shiftLeft(xi, a.gain_shift_up),
+                                                      fitValue<M>(int64_t(a.one) + xi, a.ratio), a.gain));
+    }
+    for (size_t k = 0; k < num_bins; k++){
+        const int64_t g = gain[k];
+        out[2 * k] = static_cast<int32_t>(fitValue<M>(shiftRound<M>(X[2 * k] * g, a.gain_shift, a.data), a.data));
+        out[2 * k + 1] = static_cast<int32_t>(fitValue<M>(shiftRound<M>(X[2 * k + 1] * g, a.gain_shift, a.data), a.data));
+    }
+}
+
+} // namespace
+
+// One instruction set's build of every kernel, for one KernelMode
+struct FixedPointKernels {
+    void (*quantize_double)(const double* in, size_t count, double scale, const Fit& f, int32_t* out);
+    void (*quantize_float)(const float* in, size_t count, double scale, const Fit& f, int32_t* out);
+    void (*power)(const int32_t* X, size_t num_bins, const Shift& s, const Fit& f, int32_t* psd);
+    void (*noise)(size_t num_bins, const int32_t* psd, int32_t* smoothed, int32_t* row, int32_t* prefix,
+                  const int32_t* suffix, bool block_start, int32_t* noise, const NoiseArgs& a);
+    void (*suffix_min)(size_t num_bins, const int32_t* next, int32_t* cur);
+    void (*wiener)(size_t num_bins, const int32_t* X, const int32_t* psd, const int32_t* noise,
+                   int32_t* p_xi, int32_t* p_SNR, int32_t* gain, int32_t* out, const WienerArgs& a);
+};
+
+#define FIXED_POINT_KERNELS(NAME, ATTRIBUTES)                                                                   \
+    namespace NAME {                                                                                            \
+    template <unsigned M>                                                                                       \
+    ATTRIBUTES void quantizeDouble(const double* in, size_t count, double scale, const Fit& f, int32_t* out) {  \
+        quantizeBody<M>(in, count, scale, f, out);                                                              \
+    }                                                                                                           \
+    template <unsigned M>                                                                                       \
+    ATTRIBUTES void quantizeFloat(const float* in, size_t count, double scale, const Fit& f, int32_t* out) {    \
+        quantizeBody<M>(in, count, scale, f, out);                                                              \
+    }                                                                                                           \
+    template <unsigned M>                                                                                       \
+    ATTRIBUTES void power(const int32_t* X, size_t num_bins, const Shift& s, const Fit& f, int32_t* psd) {      \
+        powerBody<M>(X, num_bins, s, f, psd);                                                                   \
+    }                                                                                                           \
+    template <unsigned M>                                                                                       \
+    ATTRIBUTES void noise(size_t num_bins, const int32_t* psd, int32_t* smoothed, int32_t* row, int32_t* prefix, \
+                          const int32_t* suffix, bool block_start, int32_t* noise, const NoiseArgs& a) {        \
+        noiseBody<M>(num_bins, psd, smoothed, row, prefix, suffix, block_start, noise, a);                      \
+    }                                                                                                           \
+    ATTRIBUTES void suffixMin(size_t num_bins, const int32_t* next, int32_t* cur) {                             \
+        suffixMinBody(num_bins, next, cur);                                                                     \
+    }                                                                                                           \
+    template <unsigned M>                                                                                       \
+    ATTRIBUTES void wiener(size_t num_bins, const int32_t* X, const int32_t* psd, const int32_t* noise,         \
+                           int32_t* p_xi, int32_t* p_SNR, int32_t* gain, int32_t* out, const WienerArgs& a) {   \
+        wienerBody<M>(num_bins, X, psd, noise, p_xi, p_SNR, gain, out, a);                                      \
+    }                                                                                                           \
+    template <unsigned M>                                                                                       \
+    constexpr FixedPointKernels forMode() {                                                                     \
+        return {quantizeDouble<M>, quantizeFloat<M>, power<M>, noise<M>, suffixMin, wiener<M>};                 \
+    }                                                                                                           \
+    const FixedPointKernels kernels[kKernelModes] = {forMode<FloorSaturate>(), forMode<FloorWrap>(),            \
+        forMode<EvenSaturate>(), forMode<EvenWrap>(), forMode<MixedModes>()};                                   \
+    }
+
+namespace {
+FIXED_POINT_KERNELS(fixed_baseline, )
+#ifdef FIXED_X86
+FIXED_POINT_KERNELS(fixed_avx2, __attribute__((target("avx2"))))
+// 64-bit multiplies and int64/double conversions need AVX512DQ, without it the AVX2 build is used
+FIXED_POINT_KERNELS(fixed_avx512, __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl,prefer-vector-width=512"))))
+#endif
+} // namespace
+
+static const FixedPointKernels* fixedPointKernels(SimdLevel level, const FixedPointConfig& config) {
+    const unsigned mode = kernelMode(config);
+#ifdef FIXED_X86
+    if (level == SimdLevel::AVX512 && __builtin_cpu_supports("avx512dq")) return &fixed_avx512::kernels[mode];
+    if (level == SimdLevel::AVX512 || level == SimdLevel::AVX2) return &fixed_avx2::kernels[mode];
+#endif
+    (void)level;
+    return &fixed_baseline::kernels[mode];
+}
+
+int32_t FixedPointFormat::quantize(double value) const {
+    return static_cast<int32_t>(quantizeValue<MixedModes>(value, std::ldexp(1.0, static_cast<int>(frac_bits)), makeFit(*this)));
+}
+
+double FixedPointFormat::toDouble(int64_t raw) const {
+    return std::ldexp(static_cast<double>(raw), -static_cast<int>(frac_bits));
+}
+
+void FixedPointFormat::validate(const char* name) const {
+    const unsigned max_bits = is_signed ? 32 : 31;
+    if (total_bits < 2 || total_bits > max_bits || frac_bits > 31) {
+        throw std::invalid_argument(std::string("Unsupported fixed-point format for ") + name + ": " +
+                                    std::to_string(total_bits) + " bits with " + std::to_string(frac_bits) +
+                                    " fraction bits");
+    }
+}
+
+FixedPointConfig FixedPointConfig::q15() {
+    FixedPointConfig config;
+    config.data = {16, 15};
+    config.power = {32, 30};                // |X|² of Q15 words without rounding; only -1 - 1j (2.0) saturates
+    config.ratio = {32, 16};
+    config.gain = {16, 15};
+    config.coef = {16, 14};
+    return config;
+}
+
+FixedPointConfig FixedPointConfig::q31() {
+    FixedPointConfig config;
+    config.data = {32, 31};
+    config.power = {32, 30};                // Same range as q15, |X|² of full-scale data up to 2.0 without saturating
+    config.ratio = {32, 16};
+    config.gain = {32, 31};
+    config.coef = {32, 30};
+    return config;
+}
+
+void FixedPointConfig::setRounding(FixedRounding rounding) {
+    for (FixedPointFormat* format : {&data, &power, &ratio, &gain, &coef}) format->rounding = rounding;
+}
+
+void FixedPointConfig::setOverflow(FixedOverflow overflow) {
+    for (FixedPointFormat* format : {&data, &power, &ratio, &gain, &coef}) format->overflow = overflow;
+}
+
+void FixedPointConfig::validate() const {
+    data.validate("data");
+    power.validate("power");
+    ratio.validate("ratio");
+    gain.validate("gain");
+    coef.validate("coef");
+    if (power.frac_bits > 2 * data.frac_bits) {
+        throw std::invalid_argument("The power format cannot have more fraction bits than |X|² of the data format");
+    }
+}
+
+
+//Minimum Statistics Noise Estimator, in fixed point
+// The history starts filled with d frames of 1.0, as in NoiseEstimator
+FixedPointNoiseEstimator::FixedPointNoiseEstimator(size_t num_bins_param, size_t d_param, const FixedPointConfig& config_param,
+                                                   SimdLevel simd)
+: num_bins((config_param.validate(), num_bins_param)), d(d_param), stride(paddedCount<int32_t>(num_bins_param)),
+psd_smoothed(num_bins_param, 0), psd_noise_est(num_bins_param, config_param.power.quantize(1e-10)),
+psd_history_buffer(d_param * stride, config_param.power.quantize(1.0)),
+psd_prefix_min(stride, config_param.power.quantize(1.0)), pos(0), config(config_param),
+alpha(config.coef.quantize(0.8)), one_minus_alpha(config.coef.quantize(1 - 0.8)), bias(config.coef.quantize(1.2)),
+kernels(fixedPointKernels(simd, config_param)){}
+
+void FixedPointNoiseEstimator::update(const int32_t* current_power_spectrum){
+    int32_t* row = &psd_history_buffer[pos * stride];
+    int32_t* prefix = psd_prefix_min.data();
+    // Suffix minima of the previous block still in the window, none left at the end of a block
+    const int32_t* suffix = (pos + 1 < d) ? row + stride : prefix;
+    const NoiseArgs args = {alpha, one_minus_alpha, bias, makeShift(static_cast<int>(config.coef.frac_bits)),
+                            makeFit(config.power)};
+    kernels->noise(num_bins, current_power_spectrum, psd_smoothed.data(), row, prefix, suffix, pos == 0,
+                   psd_noise_est.data(), args);
+
+    if (pos + 1 < d){
+        pos++;
+        return;
+    }
+    // End of block: turn its rows into suffix minima
+    for (size_t j = d - 1; j-- > 0;){
+        kernels->suffix_min(num_bins, &psd_history_buffer[(j + 1) * stride], &psd_history_buffer[j * stride]);
+    }
+    pos = 0;
+}
+
+
+// Decision-Directed Wiener filter, in fixed point
+FixedPointWienerFilter::FixedPointWienerFilter(size_t num_bins_param, const FixedPointConfig& config_param, SimdLevel simd)
+: num_bins((config_param.validate(), num_bins_param)), p_xi(num_bins_param, 0), p_SNR(num_bins_param, config_param.ratio.quantize(1e-10)),
+gain(num_bins_param),
+config(config_param), alpha_w(config.coef.quantize(0.35)), one_minus_alpha_w(config.coef.quantize(1 - 0.35)),
+alpha_snr(config.coef.quantize(0.15)), one_minus_alpha_snr(config.coef.quantize(1 - 0.15)),
+one(config.ratio.quantize(1.0)), xi_floor(config.ratio.quantize(1e-10)), kernels(fixedPointKernels(simd, config_param)){}
+
+void FixedPointWienerFilter::apply(const int32_t* current_frame, const int32_t* psd, const int32_t* psd_noise_est,
+                                   int32_t* filtered_frame){
+    const WienerArgs args = {alpha_w, one_minus_alpha_w, alpha_snr, one_minus_alpha_snr, one, xi_floor,
+                             static_cast<int>(config.ratio.frac_bits), static_cast<int>(config.gain.frac_bits),
+                             makeShift(static_cast<int>(config.coef.frac_bits)),
+                             makeShift(static_cast<int>(config.gain.frac_bits)),
+                             makeFit(config.data), makeFit(config.ratio), makeFit(config.gain)};
+    kernels->wiener(num_bins, current_frame, psd, psd_noise_est, p_xi.data(), p_SNR.data(), gain.data(),
+                    filtered_frame, args);
+}
+
+
+template <typename T>
+FixedPointStage<T>::FixedPointStage(size_t num_bins_param, size_t d, const FixedPointConfig& config_param, SimdLevel simd)
+: num_bins(num_bins_param), config(config_param), estimator(num_bins_param, d, config_param, simd),
+filter(num_bins_param, config_param, simd), kernels(fixedPointKernels(simd, config_param)), spectrum(2 * num_bins_param),
+psd(num_bins_param), filtered(2 * num_bins_param), noise(num_bins_param, T(0)){}
+
+template <typename T>
+void FixedPointStage<T>::estimateNoise(const std::complex<T>* current_frame, T* frame_psd){
+    const Fit data = makeFit(config.data);
+    const double scale = std::ldexp(1.0, static_cast<int>(config.data.frac_bits));
+    if constexpr (std::is_same<T, double>::value) {
+        kernels->quantize_double(reinterpret_cast<const double*>(current_frame), 2 * num_bins, scale, data, spectrum.data());
+    } else {
+        kernels->quantize_float(reinterpret_cast<const float*>(current_frame), 2 * num_bins, scale, data, spectrum.data());
+    }
+    kernels->power(spectrum.data(), num_bins, makeShift(static_cast<int>(2 * config.data.frac_bits - config.power.frac_bits)),
+                   makeFit(config.power), psd.data());
+    estimator.update(psd.data());
+
+    // Exact in double, rounded once for float
+    const double power_lsb = std::ldexp(1.0, -static_cast<int>(config.power.frac_bits));
+    const int32_t* noise_raw = estimator.getNoiseEstimate();
+    for (size_t k = 0; k < num_bins; k++){
+        frame_psd[k] = static_cast<T>(psd[k] * power_lsb);
+        noise[k] = static_cast<T>(noise_raw[k] * power_lsb);
+    }
+}
+
+template <typename T>
+void FixedPointStage<T>::filterSpectrum(std::complex<T>* filtered_frame){
+    filter.apply(spectrum.data(), psd.data(), estimator.getNoiseEstimate(), filtered.data());
+    const double data_lsb = std::ldexp(1.0, -static_cast<int>(config.data.frac_bits));
+    T* out = reinterpret_cast<T*>(filtered_frame);
+    for (size_t i = 0; i < 2 * num_bins; i++){
+        out[i] = static_cast<T>(filtered[i] * data_lsb);
+    }
+}
+
+template class FixedPointStage<double>;
+template class FixedPointStage<float>;
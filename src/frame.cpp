@@ -1,15 +1,26 @@
-// frame.cpp
 #include "frame.hpp"
 #include <filesystem>
 
 // frame.cpp
-Frame::Frame(size_t frameSize, const std::vector<float>& coeffs)
+template <typename T>
+BasicFrame<T>::BasicFrame(size_t frameSize, const std::vector<float>& coeffs)
     : size(frameSize), windowCoeffs(coeffs) {}
 
-std::vector<double> Frame::generateFrame(const std::vector<float>& input, size_t startIndex) {
-    std::vector<double> frame(size);
+template <typename T>
+std::vector<T> BasicFrame<T>::generateFrame(const std::vector<float>& input, size_t startIndex) {
+    std::vector<T> frame(size);
     for (size_t i = 0; i < size; ++i) {
         frame[i] = static_cast<float>(input[startIndex + i]) * windowCoeffs[i];
     }
     return frame;
-}
\ No newline at end of file
+}
+
+template <typename T>
+void BasicFrame<T>::generateFrame(const float* input, T* frame, size_t stride) const {
+    for (size_t i = 0; i < size; ++i) {
+        frame[i] = static_cast<float>(input[i * stride]) * windowCoeffs[i];
+    }
+}
+
+template class BasicFrame<double>;
+template class BasicFrame<float>;
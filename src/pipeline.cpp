@@ -0,0 +1,331 @@
+#include "pipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "fileio.hpp"
+#include "denoise_engine.hpp"
+#include "fixed_denoise_engine.hpp"
+#include "thread_pool.hpp"
+#include "dsp_worker.hpp"
+#include "spsc_ring.hpp"
+#include "stage_timer.hpp"
+
+namespace {
+
+// Streams of the requested outputs, the ones left out stay null and cost nothing
+struct TapSinks {
+    std::unique_ptr<FrameSink> frames;                            // Windowed frames
+    std::unique_ptr<SpectrumSink> results_fft;                    // FFT results
+    std::unique_ptr<FrameSink> psd_signal_frames;                 // Signal PSD results
+    std::unique_ptr<FrameSink> psd_noise_frames;                  // Noise PSD results
+    std::unique_ptr<FrameSink> recon_signal;                      // Reconstructed signal
+};
+
+// The sinks store doubles, the outputs of the float engine are widened on the way
+template <typename Sink, typename Value>
+void writeTap(Sink* sink, const Value* data, size_t count) {
+    if (!sink) return;
+    if constexpr (std::is_same_v<Value, double> || std::is_same_v<Value, std::complex<double>>) {
+        sink->write(data, count);
+    } else {
+        using Wide = std::conditional_t<std::is_same_v<Value, float>, double, std::complex<double>>;
+        thread_local std::vector<Wide> wide;
+        wide.assign(data, data + count);
+        sink->write(wide.data(), count);
+    }
+}
+
+// Frame loop shared by the runtime DenoiseEngine and the fixed-size engines, which only run frame by
+// frame. Adds the samples read to total_samples and returns the number of frames processed.
+template <typename Engine>
+size_t runFrames(Engine& engine, SampleSource& source, const RunConfig& config, TapSinks& sinks,
+                 size_t channels, size_t block, size_t& total_samples) {
+    const size_t frame_len = engine.frameSize() * channels;      // Interleaved samples of a frame
+    const size_t hop_len = engine.hopSize() * channels;           // Interleaved samples of a hop
+    const size_t bins_len = engine.binCount() * channels;
+    std::vector<typename Engine::sample_type> recon_block(block * hop_len);   // To store the hop samples completed by each frame of the block
+
+    // Only the current block of frames and the next hop of samples are kept in memory, interleaved for
+    // several channels. A frame is processed when at least one sample follows it in the input.
+    std::vector<float> samples((block - 1) * hop_len + frame_len + hop_len);
+    size_t filled = 0;
+
+    size_t frame_counter = 0;
+    while (true) {
+        // Top the buffer up, a short read means the end of the input
+        while (filled < samples.size()) {
+            const size_t n = source.read(samples.data() + filled, samples.size() - filled);
+            if (n == 0) break;
+            filled += n;
+            total_samples += n;
+        }
+        if (filled <= frame_len) break;
+        const size_t count = std::min(block, (filled - frame_len - 1) / hop_len + 1);
+
+        // Denoise the frames, recon_block receives the hop samples each of them completes
+        if (count == 1) {
+            engine.processFrame(samples.data(), recon_block.data());
+            if (config.recordsFrame(frame_counter)) {
+                StageTimer timer(Stage::Write);
+                writeTap(sinks.frames.get(), engine.windowedFrame().data(), frame_len);
+                writeTap(sinks.results_fft.get(), engine.spectrum().data(), bins_len);
+                writeTap(sinks.psd_signal_frames.get(), engine.signalPSD().data(), bins_len);
+                writeTap(sinks.psd_noise_frames.get(), engine.noisePSD().data(), bins_len);
+            }
+        } else if constexpr (std::is_same_v<Engine, BasicDenoiseEngine<typename Engine::sample_type>>) {
+            engine.processFrames(samples.data(), count, recon_block.data());
+            StageTimer timer(Stage::Write);
+            for (size_t j = 0; j < count; j++) {
+                if (!config.recordsFrame(frame_counter + j)) continue;
+                writeTap(sinks.frames.get(), engine.blockFrame(j), frame_len);
+                writeTap(sinks.results_fft.get(), engine.blockSpectrum(j), bins_len);
+                writeTap(sinks.psd_signal_frames.get(), engine.blockSignalPSD(j), bins_len);
+                writeTap(sinks.psd_noise_frames.get(), engine.blockNoisePSD(j), bins_len);
+            }
+        }
+        if (sinks.recon_signal) {
+            StageTimer timer(Stage::Write);
+            writeTap(sinks.recon_signal.get(), recon_block.data(), count * hop_len);
+        }
+
+        // Slide the input by the hops consumed
+        std::copy(samples.begin() + count * hop_len, samples.begin() + filled, samples.begin());
+        filled -= count * hop_len;
+
+        // Increment counter
+        frame_counter += count;
+    }
+    return frame_counter;
+}
+
+template <typename T>
+void printBlockTiming(const BasicDenoiseEngine<T>& engine) {
+    std::cout << "--- Real-time: worst block " << engine.worstBlockTime() * 1e6 << " us of a "
+              << engine.hopSize() * 1e6 / engine.sampleRate() << " us budget, " << engine.overruns() << " of "
+              << engine.blockCount() << " blocks over budget, latency " << engine.blockLatency()
+              << " samples" << std::endl;
+}
+
+// Real-time simulation: the input is pushed through DenoiseEngine::processBlock() one hop at a time, as
+// an audio callback would. The leading zeros of the output are dropped, so it lines up with the input.
+template <typename T>
+size_t runRealtime(BasicDenoiseEngine<T>& engine, SampleSource& source, const RunConfig& config, TapSinks& sinks,
+                   size_t channels, size_t& total_samples) {
+    const size_t hop_len = engine.hopSize() * channels;
+    const size_t bins_len = engine.binCount() * channels;
+    std::vector<float> in(hop_len);
+    std::vector<float> out(hop_len);
+    std::vector<double> recon_block(hop_len);
+    registerStageTimerThread();                                   // Before the first processBlock()
+
+    size_t frame_counter = 0;
+    while (true) {
+        size_t filled = 0;
+        while (filled < hop_len) {
+            const size_t n = source.read(in.data() + filled, hop_len - filled);
+            if (n == 0) break;
+            filled += n;
+        }
+        total_samples += filled;
+        if (filled < hop_len) break;                              // A callback always gets a whole hop
+
+        engine.processBlock(in.data(), out.data(), engine.hopSize());
+        if (engine.frameCount() == frame_counter) continue;      // First frame not complete yet
+
+        StageTimer timer(Stage::Write);
+        if (config.recordsFrame(frame_counter)) {
+            writeTap(sinks.frames.get(), engine.windowedFrame().data(), engine.frameSize() * channels);
+            writeTap(sinks.results_fft.get(), engine.spectrum().data(), bins_len);
+            writeTap(sinks.psd_signal_frames.get(), engine.signalPSD().data(), bins_len);
+            writeTap(sinks.psd_noise_frames.get(), engine.noisePSD().data(), bins_len);
+        }
+        if (sinks.recon_signal) {
+            std::copy(out.begin(), out.end(), recon_block.begin());
+            sinks.recon_signal->write(recon_block.data(), hop_len);
+        }
+        frame_counter++;
+    }
+    return frame_counter;
+}
+
+// Live simulation: a synthetic capture thread pushes the input into an SPSC ring in small chunks, a
+// DspWorker denoises it hop by hop on its own thread, and the calling thread plays the role of the
+// playback thread, draining the output ring into the reconstructed signal. speed paces the capture
+// thread at that many times real time, 0 runs it as fast as possible. Only the signal tap is written.
+size_t runLive(DenoiseEngine& engine, SampleSource& source, const RunConfig& config, TapSinks& sinks,
+               size_t channels, size_t& total_samples) {
+    const size_t hop_len = engine.hopSize() * channels;
+    const size_t frame_len = engine.frameSize() * channels;
+    SpscRing<float> captured(4 * frame_len);
+    SpscRing<float> denoised(4 * frame_len);
+    DspWorker worker(engine, captured, denoised);
+    // The worker runs before the capture thread exists, so a short input cannot finish it before its start
+    const auto live_start = std::chrono::steady_clock::now();
+    worker.start();
+
+    // Capture thread: the input arrives in chunks of 64 samples per channel, like a sound card period
+    std::atomic<size_t> captured_samples{0};
+    std::atomic<size_t> stalls{0};
+    std::thread capture([&] {
+        std::vector<float> period(64 * channels);
+        const double rate = engine.sampleRate() * config.live_speed * channels;
+        const auto start = std::chrono::steady_clock::now();
+        size_t pushed = 0;
+        while (size_t n = source.read(period.data(), period.size())) {
+            if (rate > 0.0) {
+                std::this_thread::sleep_until(start + std::chrono::duration<double>(pushed / rate));
+            }
+            for (size_t done = 0; done < n;) {
+                const size_t written = captured.write(period.data() + done, n - done);
+                if (written == 0) {
+                    stalls.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+                done += written;
+            }
+            pushed += n;
+        }
+        captured_samples.store(pushed, std::memory_order_relaxed);
+        worker.finish();
+    });
+
+    // Playback side: skip the leading zeros of the latency so the output lines up with the input
+    std::vector<float> out(hop_len);
+    std::vector<double> recon_block(hop_len);
+    size_t skip = engine.blockLatency() * channels;
+    size_t received = 0;
+    while (true) {
+        const bool last = worker.finished();
+        size_t n;
+        while ((n = denoised.read(out.data(), out.size())) > 0) {
+            const size_t dropped = std::min(skip, n);
+            skip -= dropped;
+            if (sinks.recon_signal && n > dropped) {
+                StageTimer timer(Stage::Write);
+                std::copy(out.begin() + dropped, out.begin() + n, recon_block.begin());
+                sinks.recon_signal->write(recon_block.data(), n - dropped);
+            }
+            received += n - dropped;
+        }
+        if (last) break;
+        std::this_thread::yield();
+    }
+    capture.join();
+    worker.stop();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - live_start).count();
+
+    total_samples += captured_samples.load();
+    const double audio_seconds = static_cast<double>(total_samples) / channels / engine.sampleRate();
+    std::cout << "--- Live: " << worker.blockCount() << " blocks through the DSP thread in " << seconds << " s, "
+              << audio_seconds / seconds << "x real time, " << stalls.load() << " capture stalls on a full ring"
+              << std::endl;
+    return received / hop_len;
+}
+
+// Real-time or frame/block run of the runtime engine in precision T
+template <typename T>
+size_t runEngine(const std::vector<float>& window, size_t hop, size_t d, SampleSource& source,
+                 const RunConfig& config, TapSinks& sinks, size_t channels, size_t& total_samples) {
+    BasicDenoiseEngine<T> engine(window, hop, d, channels);      // Windowing, FFT, noise estimation, Wiener filter and overlap-add
+    engine.setSampleRate(source.sampleRate() ? source.sampleRate() : config.sample_rate);
+    if (config.fixed_point) {
+        engine.setFixedPoint(config.fixed_point_config);
+    }
+    if (config.fixed_fft) {
+        engine.setFixedFFT(config.fixed_fft_config);
+    }
+    if (config.realtime) {
+        const size_t frames = runRealtime(engine, source, config, sinks, channels, total_samples);
+        printBlockTiming(engine);
+        return frames;
+    }
+
+    // Blocks of frames are analysed and synthesised on every core, only the recursions stay sequential.
+    // The bins of those recursions can be split across the cores too.
+    const size_t block = config.block_frames;                     // Frames processed per engine call
+    std::unique_ptr<ThreadPool> pool;
+    if ((block > 1 || config.split_bins) && config.jobs != 1) {
+        pool = std::make_unique<ThreadPool>(config.jobs);
+        engine.setThreadPool(pool.get());
+        engine.setBinSplit(config.split_bins);
+    }
+    return runFrames(engine, source, config, sinks, channels, block, total_samples);
+}
+
+} // namespace
+
+size_t denoiseFile(const RunConfig& config, const std::vector<float>& window, size_t hop, size_t d) {
+    auto source_ptr = openSampleSource(config.input_file, config.channels);  // .wav, raw int16 .pcm/.raw, or the legacy '0'/'1' text format
+    SampleSource& source = *source_ptr;
+    if (config.taps != TapNone) {
+        std::filesystem::create_directories(config.output_dir);
+    }
+
+    const size_t frame_size = window.size();
+    const size_t fft_size = (frame_size / 2) + 1;
+    const size_t channels = source.channels();
+    const size_t block = config.block_frames;                     // Frames processed per engine call
+
+    // The live mode runs the engine on another thread and only streams the reconstructed signal
+    const bool frame_taps = !config.live;
+    TapSinks sinks;
+    if (frame_taps && config.enabled(TapFrames)) sinks.frames = openFrameSink(config.outputPath("output_frames"), frame_size, config.format);
+    if (frame_taps && config.enabled(TapFFT)) sinks.results_fft = openSpectrumSink(config.outputPath("output_fft"), fft_size, config.format);
+    if (frame_taps && config.enabled(TapPSD)) sinks.psd_signal_frames = openFrameSink(config.outputPath("output_psd_signal"), fft_size, config.format);
+    if (frame_taps && config.enabled(TapNoisePSD)) sinks.psd_noise_frames = openFrameSink(config.outputPath("output_psd_est_noise"), fft_size, config.format);
+    if (config.enabled(TapSignal)) sinks.recon_signal = openSignalSink(config.outputPath("output_recon_signal"), config.format, channels);
+
+    size_t total_samples = 0;
+    size_t frame_counter = 0;
+    if (config.live) {
+        DenoiseEngine engine(window, hop, d, channels);
+        engine.setSampleRate(source.sampleRate() ? source.sampleRate() : config.sample_rate);
+        if (config.fixed_point) {
+            engine.setFixedPoint(config.fixed_point_config);
+        }
+        if (config.fixed_fft) {
+            engine.setFixedFFT(config.fixed_fft_config);
+        }
+        frame_counter = runLive(engine, source, config, sinks, channels, total_samples);
+        printBlockTiming(engine);
+    } else if (config.single_precision) {
+        frame_counter = runEngine<float>(window, hop, d, source, config, sinks, channels, total_samples);
+    } else if (!config.realtime && frame_size == 256 && hop == 128 && d == 64 && channels == 1 && block == 1 &&
+               !config.split_bins && !config.fixed_point && !config.fixed_fft) {
+        // The default configuration runs on the engine specialized for it at compile time
+        auto engine = std::make_unique<FixedDenoiseEngine<256, 128>>(window);
+        frame_counter = runFrames(*engine, source, config, sinks, channels, 1, total_samples);
+    } else {
+        frame_counter = runEngine<double>(window, hop, d, source, config, sinks, channels, total_samples);
+    }
+
+    const size_t reconstructed = frame_counter * hop * channels;
+
+    // Close the windowed frames, FFT and PSD files
+    if (sinks.frames) sinks.frames->close();
+    if (sinks.results_fft) sinks.results_fft->close();
+    if (sinks.psd_signal_frames) sinks.psd_signal_frames->close();
+    if (sinks.psd_noise_frames) sinks.psd_noise_frames->close();
+
+    if (sinks.recon_signal) {
+        // Count the input samples left after the last frame
+        std::vector<float> rest(hop * channels);
+        while (size_t n = source.read(rest.data(), rest.size())) {
+            total_samples += n;
+        }
+
+        // The samples after the last frame are not reconstructed, pad them with zeros
+        const std::vector<double> zeros(hop * channels, 0.0);
+        for (size_t written = reconstructed; written < total_samples; written += zeros.size()) {
+            sinks.recon_signal->write(zeros.data(), std::min(zeros.size(), total_samples - written));
+        }
+        sinks.recon_signal->close();
+    }
+
+    return frame_counter;
+}
@@ -0,0 +1,305 @@
+#include "run_config.hpp"
+#include <cctype>
+#include <stdexcept>
+#include <sstream>
+#include "fileio.hpp"
+
+static const char* kUsage =
+    "Usage: AudioFilterSim [options] [input_file]\n"
+    "  input_file          .wav, raw int16 .pcm/.raw or '0'/'1' text file (default audio_file.txt)\n"
+    "  --channels=N        Interleaved channels of a raw int16 input (default 1)\n"
+    "  --rate=HZ           Sample rate of a raw int16 or text input (default 48000)\n"
+    "  --frame=N           Frame size of a generated --window, a power of two from 64 to 8192\n"
+    "                      (default 256)\n"
+    "  --overlap=P         Overlap of consecutive frames in percent: 0, 50 (default), 75 or 87.5\n"
+    "  --window=NAME       Generate the analysis window instead of reading the hardware one: hann,\n"
+    "                      sqrt-hann, hamming, blackman or rect, normalized so that the overlap-add\n"
+    "                      has unit gain\n"
+    "  --window-file=PATH  Q15 hex window coefficients, one per line, used as is (the frame size is\n"
+    "                      their count). Default include/coeffs_hex.mem, the hardware window\n"
+    "  --noise-window=N    Frames of the minimum statistics window of the noise estimator (default 64)\n"
+    "  --precision=P       Arithmetic of the denoising chain: double (default) or float\n"
+    "  --fixed=PRESET      Run the noise estimator and Wiener filter bit-true in fixed point: q15\n"
+    "                      (16-bit data, gain and coefficients, 32-bit power and ratio) or q31\n"
+    "  --qformat=LIST      Override fixed-point word formats, a comma separated list of NAME:T.F with\n"
+    "                      T total and F fraction bits (prefix T with u for unsigned) and NAME one of\n"
+    "                      data, power, ratio, gain, coef, e.g. power:32.28,ratio:24.12\n"
+    "  --rounding=MODE     Fixed-point rounding: trunc (default), round or round_even\n"
+    "  --overflow=MODE     Fixed-point overflow: saturate (default) or wrap\n"
+    "  --fft=ENGINE        FFT/IFFT: pocketfft (default), or fixed16 / fixed32 for the bit-accurate\n"
+    "                      block-floating-point FFT on 16 or 32-bit words, rounded as --rounding\n"
+    "  --twiddle-bits=N    Twiddle word length of the fixed-point FFT (default the word length)\n"
+    "  --block=K           Window and FFT K frames at a time with batched transforms (default 1)\n"
+    "  --split-bins        Split the noise estimation and filtering of each frame across the --jobs\n"
+    "                      threads, for large frames\n"
+    "  --realtime          Push the input one hop at a time through the allocation-free real-time\n"
+    "                      interface and report the worst-case block time\n"
+    "  --live              Simulate a live chain: a capture thread, a DSP thread and the playback side\n"
+    "                      linked by lock-free rings. Writes the reconstructed signal only\n"
+    "  --speed=X           Pace the --live capture thread at X times real time (default: as fast as\n"
+    "                      possible)\n"
+    "  --out=DIR           Output directory (default out)\n"
+    "  --binary            Write .bin frame containers instead of .txt files\n"
+    "  --taps=LIST         Outputs to write: all (default), none, final, or a comma separated list of\n"
+    "                      frames, fft, psd, noise, signal. final is the reconstructed signal only\n"
+    "  --batch=PATH        Denoise every file listed in a manifest (one path per line) or found in a\n"
+    "                      directory, each into its own subdirectory of the output directory\n"
+    "  --jobs=N            Worker threads of a batch, or of a single --block run (default one per\n"
+    "                      hardware thread)\n"
+    "  --every=N           Record the per-frame taps every Nth frame\n"
+    "  --range=FIRST:LAST  Record the per-frame taps from frame FIRST to frame LAST (inclusive)\n";
+
+const char* runConfigUsage() {
+    return kUsage;
+}
+
+static size_t parseCount(const std::string& value, const std::string& option) {
+    size_t pos = 0;
+    unsigned long long n = 0;
+    try {
+        // std::stoull would wrap a negative count around to a huge one
+        if (!value.empty() && std::isdigit(static_cast<unsigned char>(value[0]))) n = std::stoull(value, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size()) {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return static_cast<size_t>(n);
+}
+
+static unsigned parseTaps(const std::string& value) {
+    if (value == "all") return TapAll;
+    if (value == "none") return TapNone;
+    if (value == "final") return TapSignal;
+
+    unsigned taps = TapNone;
+    std::istringstream list(value);
+    std::string name;
+    while (std::getline(list, name, ',')) {
+        if (name == "frames") taps |= TapFrames;
+        else if (name == "fft") taps |= TapFFT;
+        else if (name == "psd") taps |= TapPSD;
+        else if (name == "noise") taps |= TapNoisePSD;
+        else if (name == "signal") taps |= TapSignal;
+        else throw std::invalid_argument("Unknown tap: " + name);
+    }
+    return taps;
+}
+
+static size_t parseOverlap(const std::string& value) {
+    if (value == "0") return 1;
+    if (value == "50") return 2;
+    if (value == "75") return 4;
+    if (value == "87.5") return 8;
+    throw std::invalid_argument("Invalid value for --overlap, expected 0, 50, 75 or 87.5: " + value);
+}
+
+static WindowType parseWindow(const std::string& value) {
+    for (WindowType type : {WindowType::Hann, WindowType::SqrtHann, WindowType::Hamming,
+                            WindowType::Blackman, WindowType::Rectangular}) {
+        if (value == windowTypeName(type)) return type;
+    }
+    throw std::invalid_argument("Unknown window: " + value);
+}
+
+// NAME:T.F items of --qformat, applied over the formats of config
+static void parseQFormats(const std::string& value, FixedPointConfig& config) {
+    std::istringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        const size_t colon = item.find(':');
+        const size_t dot = item.find('.', colon);
+        if (colon == std::string::npos || dot == std::string::npos) {
+            throw std::invalid_argument("Invalid fixed-point format, expected NAME:T.F: " + item);
+        }
+        const std::string name = item.substr(0, colon);
+        std::string total = item.substr(colon + 1, dot - colon - 1);
+        FixedPointFormat* format = nullptr;
+        if (name == "data") format = &config.data;
+        else if (name == "power") format = &config.power;
+        else if (name == "ratio") format = &config.ratio;
+        else if (name == "gain") format = &config.gain;
+        else if (name == "coef") format = &config.coef;
+        else throw std::invalid_argument("Unknown fixed-point quantity: " + name);
+        format->is_signed = (total.empty() || total[0] != 'u');
+        if (!format->is_signed) total.erase(0, 1);
+        format->total_bits = static_cast<unsigned>(parseCount(total, "--qformat"));
+        format->frac_bits = static_cast<unsigned>(parseCount(item.substr(dot + 1), "--qformat"));
+    }
+}
+
+std::string RunConfig::outputPath(const std::string& name) const {
+    return output_dir + "/" + name + (format == OutputFormat::Binary ? ".bin" : ".txt");
+}
+
+RunConfig parseRunConfig(int argc, char* argv[]) {
+    RunConfig config;
+    // Fixed-point options apply in this order whatever their order on the command line
+    std::string qformats;
+    FixedRounding rounding = FixedRounding::Trunc;
+    FixedOverflow overflow = FixedOverflow::Saturate;
+    unsigned twiddle_bits = 0;          // 0 follows the word length of --fft
+    bool frame_given = false, window_given = false, window_file_given = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string option = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+        if (arg == "--binary") {
+            config.format = OutputFormat::Binary;
+        } else if (option == "--channels") {
+            config.channels = parseCount(value, option);
+            if (config.channels == 0) {
+                throw std::invalid_argument("--channels must be at least 1");
+            }
+        } else if (arg == "--live") {
+            config.live = true;
+        } else if (option == "--speed") {
+            size_t pos = 0;
+            try {
+                config.live_speed = std::stod(value, &pos);
+            } catch (const std::exception&) {
+                pos = 0;
+            }
+            if (pos == 0 || pos != value.size() || config.live_speed < 0.0) {
+                throw std::invalid_argument("Invalid value for --speed: " + value);
+            }
+        } else if (arg == "--realtime") {
+            config.realtime = true;
+        } else if (arg == "--split-bins") {
+            config.split_bins = true;
+        } else if (option == "--rate") {
+            config.sample_rate = parseCount(value, option);
+            if (config.sample_rate == 0) {
+                throw std::invalid_argument("--rate must be at least 1");
+            }
+        } else if (option == "--frame") {
+            config.frame_size = parseCount(value, option);
+            frame_given = true;
+            if (config.frame_size < 64 || config.frame_size > 8192 || (config.frame_size & (config.frame_size - 1)) != 0) {
+                throw std::invalid_argument("--frame must be a power of two from 64 to 8192: " + value);
+            }
+        } else if (option == "--overlap") {
+            config.overlap = parseOverlap(value);
+        } else if (option == "--noise-window") {
+            config.noise_window = parseCount(value, option);
+            if (config.noise_window == 0) {
+                throw std::invalid_argument("--noise-window must be at least 1");
+            }
+        } else if (option == "--window") {
+            config.window = parseWindow(value);
+            window_given = true;
+        } else if (option == "--window-file" && !value.empty()) {
+            config.window_file = value;
+            window_file_given = true;
+        } else if (option == "--block") {
+            config.block_frames = parseCount(value, option);
+            if (config.block_frames == 0) {
+                throw std::invalid_argument("--block must be at least 1");
+            }
+        } else if (option == "--out" && !value.empty()) {
+            config.output_dir = value;
+        } else if (option == "--batch" && !value.empty()) {
+            config.batch_path = value;
+        } else if (option == "--jobs") {
+            config.jobs = parseCount(value, option);
+        } else if (option == "--precision") {
+            if (value == "double") config.single_precision = false;
+            else if (value == "float") config.single_precision = true;
+            else throw std::invalid_argument("Invalid value for --precision, expected double or float: " + value);
+        } else if (option == "--fixed") {
+            if (value == "q15") config.fixed_point_config = FixedPointConfig::q15();
+            else if (value == "q31") config.fixed_point_config = FixedPointConfig::q31();
+            else throw std::invalid_argument("Invalid value for --fixed, expected q15 or q31: " + value);
+            config.fixed_point = true;
+        } else if (option == "--fft") {
+            if (value == "pocketfft") config.fixed_fft = false;
+            else if (value == "fixed16") config.fixed_fft_config.word_bits = 16;
+            else if (value == "fixed32") config.fixed_fft_config.word_bits = 32;
+            else throw std::invalid_argument("Invalid value for --fft, expected pocketfft, fixed16 or fixed32: " + value);
+            config.fixed_fft = (value != "pocketfft");
+        } else if (option == "--twiddle-bits") {
+            twiddle_bits = static_cast<unsigned>(parseCount(value, option));
+            if (twiddle_bits == 0) {
+                throw std::invalid_argument("--twiddle-bits must be at least 1");
+            }
+        } else if (option == "--qformat" && !value.empty()) {
+            qformats += (qformats.empty() ? "" : ",") + value;
+        } else if (option == "--rounding") {
+            if (value == "trunc") rounding = FixedRounding::Trunc;
+            else if (value == "round") rounding = FixedRounding::Round;
+            else if (value == "round_even") rounding = FixedRounding::RoundEven;
+            else throw std::invalid_argument("Invalid value for --rounding, expected trunc, round or round_even: " + value);
+        } else if (option == "--overflow") {
+            if (value == "saturate") overflow = FixedOverflow::Saturate;
+            else if (value == "wrap") overflow = FixedOverflow::Wrap;
+            else throw std::invalid_argument("Invalid value for --overflow, expected saturate or wrap: " + value);
+        } else if (option == "--taps") {
+            config.taps = parseTaps(value);
+        } else if (option == "--every") {
+            config.tap_every = parseCount(value, option);
+            if (config.tap_every == 0) {
+                throw std::invalid_argument("--every must be at least 1");
+            }
+        } else if (option == "--range") {
+            const size_t colon = value.find(':');
+            if (colon == std::string::npos) {
+                throw std::invalid_argument("Invalid value for --range, expected FIRST:LAST: " + value);
+            }
+            config.tap_first = parseCount(value.substr(0, colon), option);
+            config.tap_last = parseCount(value.substr(colon + 1), option);
+            if (config.tap_last < config.tap_first) {
+                throw std::invalid_argument("Empty frame range: " + value);
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            config.input_file = arg;
+        }
+    }
+    if (window_given && window_file_given) {
+        throw std::invalid_argument("--window and --window-file are exclusive");
+    }
+    if (frame_given && !window_given) {
+        throw std::invalid_argument("--frame sets the size of a generated window and needs --window, a window file "
+                                    "sets the frame size by its coefficient count");
+    }
+    if (window_given) {
+        config.window_file.clear();
+    }
+    if (config.live && config.single_precision) {
+        throw std::invalid_argument("--live runs in double precision only");
+    }
+    if (!qformats.empty() && !config.fixed_point) {
+        throw std::invalid_argument("--qformat needs --fixed");
+    }
+    parseQFormats(qformats, config.fixed_point_config);
+    config.fixed_point_config.setRounding(rounding);
+    config.fixed_point_config.setOverflow(overflow);
+    if (config.fixed_point) {
+        config.fixed_point_config.validate();
+    }
+    if (twiddle_bits != 0 && !config.fixed_fft) {
+        throw std::invalid_argument("--twiddle-bits needs --fft=fixed16 or --fft=fixed32");
+    }
+    config.fixed_fft_config.twiddle_bits = (twiddle_bits != 0) ? twiddle_bits : config.fixed_fft_config.word_bits;
+    config.fixed_fft_config.rounding = rounding;
+    if (config.fixed_fft) {
+        config.fixed_fft_config.validate();
+    }
+    return config;
+}
+
+std::vector<float> makeAnalysisWindow(const RunConfig& config) {
+    if (config.window_file.empty()) {
+        return makeWindow(config.window, config.frame_size, config.hopSize());
+    }
+    std::vector<float> window = readHexData(config.window_file);  // Hardware window coefficients, e.g. include/coeffs_hex.mem
+    if (window.empty() || window.size() % config.overlap != 0) {
+        throw std::runtime_error("Window file " + config.window_file + " holds " + std::to_string(window.size()) +
+                                 " coefficients, which the hop does not divide");
+    }
+    return window;
+}
@@ -0,0 +1,147 @@
+#include "stage_timer.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+constexpr size_t kSubBuckets = 8;                              // Histogram buckets per octave
+constexpr size_t kBuckets = 64 * kSubBuckets;
+
+// Values below kSubBuckets get a bucket each, larger ones 8 buckets per power of two
+size_t bucketOf(uint64_t ns) {
+    if (ns < kSubBuckets) return static_cast<size_t>(ns);
+    size_t octave = 63;
+    while (!(ns >> octave)) octave--;
+    const size_t sub = static_cast<size_t>((ns >> (octave - 3)) & (kSubBuckets - 1));
+    return (octave - 2) * kSubBuckets + sub;
+}
+
+// Middle of the range of a bucket
+double bucketValue(size_t bucket) {
+    if (bucket < kSubBuckets) return static_cast<double>(bucket);
+    const size_t octave = bucket / kSubBuckets + 2;
+    const double width = static_cast<double>(uint64_t(1) << (octave - 3));
+    return (kSubBuckets + bucket % kSubBuckets + 0.5) * width;
+}
+
+// Counters of one thread. Only the owning thread writes them, the atomics let stageSummary() read
+// them at any time without a data race.
+struct ThreadStageStats {
+    std::array<std::atomic<uint64_t>, kStageCount> count{};
+    std::array<std::atomic<uint64_t>, kStageCount> total{};
+    std::array<std::atomic<uint64_t>, kStageCount> max{};
+    std::array<std::array<std::atomic<uint64_t>, kBuckets>, kStageCount> buckets{};
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadStageStats>> registry;      // Kept after their thread exits
+
+ThreadStageStats& localStats() {
+    thread_local ThreadStageStats* stats = [] {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(std::make_unique<ThreadStageStats>());
+        return registry.back().get();
+    }();
+    return *stats;
+}
+
+// Single-writer increment, cheaper than an atomic read-modify-write
+inline void add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Window: return "window";
+        case Stage::FFT:    return "fft";
+        case Stage::PSD:    return "psd";
+        case Stage::Noise:  return "noise";
+        case Stage::Wiener: return "wiener";
+        case Stage::IFFT:   return "ifft";
+        case Stage::OLA:    return "ola";
+        case Stage::Write:  return "write";
+        default:            return "?";
+    }
+}
+
+void registerStageTimerThread() {
+    if (kStageTimersEnabled) localStats();
+}
+
+void recordStage(Stage stage, uint64_t ns) {
+    if (!kStageTimersEnabled) return;
+    ThreadStageStats& stats = localStats();
+    const size_t s = static_cast<size_t>(stage);
+    add(stats.count[s], 1);
+    add(stats.total[s], ns);
+    if (ns > stats.max[s].load(std::memory_order_relaxed)) stats.max[s].store(ns, std::memory_order_relaxed);
+    add(stats.buckets[s][bucketOf(ns)], 1);
+}
+
+std::vector<StageSummary> stageSummary() {
+    std::vector<StageSummary> summary(kStageCount);
+    std::vector<uint64_t> histogram(kBuckets);
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (size_t s = 0; s < kStageCount; s++) {
+        StageSummary& stage = summary[s];
+        stage.stage = static_cast<Stage>(s);
+        std::fill(histogram.begin(), histogram.end(), 0);
+        for (const auto& stats : registry) {
+            stage.count += stats->count[s].load(std::memory_order_relaxed);
+            stage.total += stats->total[s].load(std::memory_order_relaxed);
+            stage.max = std::max(stage.max, stats->max[s].load(std::memory_order_relaxed));
+            for (size_t b = 0; b < kBuckets; b++) {
+                histogram[b] += stats->buckets[s][b].load(std::memory_order_relaxed);
+            }
+        }
+        if (stage.count == 0) continue;
+        stage.mean = static_cast<double>(stage.total) / stage.count;
+
+        // Percentiles: the bucket holding the call of that rank
+        uint64_t seen = 0;
+        const uint64_t rank50 = (stage.count - 1) / 2 + 1;
+        const uint64_t rank99 = (stage.count * 99 + 99) / 100;
+        for (size_t b = 0; b < kBuckets; b++) {
+            if (histogram[b] == 0) continue;
+            if (seen < rank50 && seen + histogram[b] >= rank50) stage.p50 = bucketValue(b);
+            if (seen < rank99 && seen + histogram[b] >= rank99) stage.p99 = bucketValue(b);
+            seen += histogram[b];
+        }
+        // The largest bucket may reach past the exact maximum
+        stage.p50 = std::min(stage.p50, static_cast<double>(stage.max));
+        stage.p99 = std::min(stage.p99, static_cast<double>(stage.max));
+    }
+    return summary;
+}
+
+void printStageTimers(std::ostream& out) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-8s %12s %12s %10s %10s %10s %10s\n", "stage", "calls", "total ms",
+                  "mean us", "p50 us", "p99 us", "max us");
+    out << line;
+    for (const StageSummary& s : stageSummary()) {
+        if (s.count == 0) continue;
+        std::snprintf(line, sizeof(line), "%-8s %12llu %12.3f %10.3f %10.3f %10.3f %10.3f\n", stageName(s.stage),
+                      static_cast<unsigned long long>(s.count), s.total * 1e-6, s.mean * 1e-3, s.p50 * 1e-3,
+                      s.p99 * 1e-3, s.max * 1e-3);
+        out << line;
+    }
+}
+
+void resetStageTimers() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto& stats : registry) {
+        for (size_t s = 0; s < kStageCount; s++) {
+            stats->count[s].store(0, std::memory_order_relaxed);
+            stats->total[s].store(0, std::memory_order_relaxed);
+            stats->max[s].store(0, std::memory_order_relaxed);
+            for (auto& bucket : stats->buckets[s]) bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,311 @@
+// Built with -ffp-contract=off so no variant fuses multiply-adds and all stay bit-identical
+#include "wiener_kernel.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WIENER_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define WIENER_NEON 1
+#endif
+
+// Tail and fallback path, same expressions as the original per-bin loop
+template <typename T>
+static void wienerGainScalar(size_t num_bins, const std::complex<T>* X, const T* psd,
+                             const T* psd_noise_est, T* p_xi, T* p_SNR,
+                             std::complex<T>* out, T alpha_w, T alpha_snr){
+    for (size_t k = 0; k < num_bins; k++){
+        T SNR = (alpha_snr * p_SNR[k]) + ((1 - alpha_snr) * (psd[k] / (psd_noise_est[k])));
+
+        T term1 = alpha_w * p_xi[k];
+        T term2 = (1 - alpha_w) * std::max((SNR - 1), T(1e-10));  // Decision-Directed "voice detection"
+
+        // ξ(k, n) = α_dd * (ξ(k, n-1)) + (1 - α_dd) * max((|X(k, n)|² / |Ŵ(k, n)|²) - 1, 0 )
+        T xi = term1 + (term2);
+
+        // Ŝ(k, n) = ξ(k, n) / (1 + ξ(k, n)) * X(k,n)
+        T wiener_gain = std::isnan(xi) ? T(0) : xi / (T(1) + xi);
+        out[k] = X[k] * wiener_gain;
+
+        p_xi[k] = xi;
+        p_SNR[k] = SNR;
+    }
+}
+
+#ifdef WIENER_X86
+// 4 bins per iteration. max_pd(floor, x) returns x when x is NaN, like std::max(x, floor),
+// and the ordered self-compare zeroes the gain where ξ is NaN.
+__attribute__((target("avx2")))
+static void wienerGainAVX2(size_t num_bins, const std::complex<double>* X, const double* psd,
+                           const double* psd_noise_est, double* p_xi, double* p_SNR,
+                           std::complex<double>* out, double alpha_w, double alpha_snr){
+    const __m256d a_snr = _mm256_set1_pd(alpha_snr);
+    const __m256d b_snr = _mm256_set1_pd(1 - alpha_snr);
+    const __m256d a_w = _mm256_set1_pd(alpha_w);
+    const __m256d b_w = _mm256_set1_pd(1 - alpha_w);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d floor = _mm256_set1_pd(1e-10);
+    const double* x = reinterpret_cast<const double*>(X);
+    double* y = reinterpret_cast<double*>(out);
+
+    size_t k = 0;
+    for (; k + 4 <= num_bins; k += 4){
+        __m256d ratio = _mm256_div_pd(_mm256_loadu_pd(psd + k), _mm256_loadu_pd(psd_noise_est + k));
+        __m256d snr = _mm256_add_pd(_mm256_mul_pd(a_snr, _mm256_loadu_pd(p_SNR + k)), _mm256_mul_pd(b_snr, ratio));
+        __m256d term1 = _mm256_mul_pd(a_w, _mm256_loadu_pd(p_xi + k));
+        __m256d term2 = _mm256_mul_pd(b_w, _mm256_max_pd(floor, _mm256_sub_pd(snr, one)));
+        __m256d xi = _mm256_add_pd(term1, term2);
+        __m256d gain = _mm256_div_pd(xi, _mm256_add_pd(one, xi));
+        gain = _mm256_and_pd(gain, _mm256_cmp_pd(xi, xi, _CMP_ORD_Q));
+
+        // Spread each gain over the real and imaginary parts of its bin
+        __m256d lo = _mm256_mul_pd(_mm256_loadu_pd(x + 2 * k), _mm256_permute4x64_pd(gain, 0x50));
+        __m256d hi = _mm256_mul_pd(_mm256_loadu_pd(x + 2 * k + 4), _mm256_permute4x64_pd(gain, 0xFA));
+        _mm256_storeu_pd(y + 2 * k, lo);
+        _mm256_storeu_pd(y + 2 * k + 4, hi);
+
+        _mm256_storeu_pd(p_xi + k, xi);
+        _mm256_storeu_pd(p_SNR + k, snr);
+    }
+    wienerGainScalar<double>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                             alpha_w, alpha_snr);
+}
+
+// 8 bins per iteration, same operations as the AVX2 kernel
+__attribute__((target("avx512f")))
+static void wienerGainAVX512(size_t num_bins, const std::complex<double>* X, const double* psd,
+                             const double* psd_noise_est, double* p_xi, double* p_SNR,
+                             std::complex<double>* out, double alpha_w, double alpha_snr){
+    const __m512d a_snr = _mm512_set1_pd(alpha_snr);
+    const __m512d b_snr = _mm512_set1_pd(1 - alpha_snr);
+    const __m512d a_w = _mm512_set1_pd(alpha_w);
+    const __m512d b_w = _mm512_set1_pd(1 - alpha_w);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d floor = _mm512_set1_pd(1e-10);
+    const __m512i spread_lo = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+    const __m512i spread_hi = _mm512_set_epi64(7, 7, 6, 6, 5, 5, 4, 4);
+    const double* x = reinterpret_cast<const double*>(X);
+    double* y = reinterpret_cast<double*>(out);
+
+    size_t k = 0;
+    for (; k + 8 <= num_bins; k += 8){
+        __m512d ratio = _mm512_div_pd(_mm512_loadu_pd(psd + k), _mm512_loadu_pd(psd_noise_est + k));
+        __m512d snr = _mm512_add_pd(_mm512_mul_pd(a_snr, _mm512_loadu_pd(p_SNR + k)), _mm512_mul_pd(b_snr, ratio));
+        __m512d term1 = _mm512_mul_pd(a_w, _mm512_loadu_pd(p_xi + k));
+        __m512d term2 = _mm512_mul_pd(b_w, _mm512_max_pd(floor, _mm512_sub_pd(snr, one)));
+        __m512d xi = _mm512_add_pd(term1, term2);
+        __m512d gain = _mm512_div_pd(xi, _mm512_add_pd(one, xi));
+        gain = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(xi, xi, _CMP_ORD_Q), gain);
+
+        __m512d lo = _mm512_mul_pd(_mm512_loadu_pd(x + 2 * k), _mm512_permutexvar_pd(spread_lo, gain));
+        __m512d hi = _mm512_mul_pd(_mm512_loadu_pd(x + 2 * k + 8), _mm512_permutexvar_pd(spread_hi, gain));
+        _mm512_storeu_pd(y + 2 * k, lo);
+        _mm512_storeu_pd(y + 2 * k + 8, hi);
+
+        _mm512_storeu_pd(p_xi + k, xi);
+        _mm512_storeu_pd(p_SNR + k, snr);
+    }
+    wienerGainScalar<double>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                             alpha_w, alpha_snr);
+}
+
+// Single precision, 8 bins per iteration, same operations as the double kernels
+__attribute__((target("avx2")))
+static void wienerGainAVX2F32(size_t num_bins, const std::complex<float>* X, const float* psd,
+                              const float* psd_noise_est, float* p_xi, float* p_SNR,
+                              std::complex<float>* out, float alpha_w, float alpha_snr){
+    const __m256 a_snr = _mm256_set1_ps(alpha_snr);
+    const __m256 b_snr = _mm256_set1_ps(1 - alpha_snr);
+    const __m256 a_w = _mm256_set1_ps(alpha_w);
+    const __m256 b_w = _mm256_set1_ps(1 - alpha_w);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 floor = _mm256_set1_ps(1e-10f);
+    const __m256i spread_lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i spread_hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    const float* x = reinterpret_cast<const float*>(X);
+    float* y = reinterpret_cast<float*>(out);
+
+    size_t k = 0;
+    for (; k + 8 <= num_bins; k += 8){
+        __m256 ratio = _mm256_div_ps(_mm256_loadu_ps(psd + k), _mm256_loadu_ps(psd_noise_est + k));
+        __m256 snr = _mm256_add_ps(_mm256_mul_ps(a_snr, _mm256_loadu_ps(p_SNR + k)), _mm256_mul_ps(b_snr, ratio));
+        __m256 term1 = _mm256_mul_ps(a_w, _mm256_loadu_ps(p_xi + k));
+        __m256 term2 = _mm256_mul_ps(b_w, _mm256_max_ps(floor, _mm256_sub_ps(snr, one)));
+        __m256 xi = _mm256_add_ps(term1, term2);
+        __m256 gain = _mm256_div_ps(xi, _mm256_add_ps(one, xi));
+        gain = _mm256_and_ps(gain, _mm256_cmp_ps(xi, xi, _CMP_ORD_Q));
+
+        __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(x + 2 * k), _mm256_permutevar8x32_ps(gain, spread_lo));
+        __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(x + 2 * k + 8), _mm256_permutevar8x32_ps(gain, spread_hi));
+        _mm256_storeu_ps(y + 2 * k, lo);
+        _mm256_storeu_ps(y + 2 * k + 8, hi);
+
+        _mm256_storeu_ps(p_xi + k, xi);
+        _mm256_storeu_ps(p_SNR + k, snr);
+    }
+    wienerGainScalar<float>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                            alpha_w, alpha_snr);
+}
+
+// Single precision, 16 bins per iteration
+__attribute__((target("avx512f")))
+static void wienerGainAVX512F32(size_t num_bins, const std::complex<float>* X, const float* psd,
+                                const float* psd_noise_est, float* p_xi, float* p_SNR,
+                                std::complex<float>* out, float alpha_w, float alpha_snr){
+    const __m512 a_snr = _mm512_set1_ps(alpha_snr);
+    const __m512 b_snr = _mm512_set1_ps(1 - alpha_snr);
+    const __m512 a_w = _mm512_set1_ps(alpha_w);
+    const __m512 b_w = _mm512_set1_ps(1 - alpha_w);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 floor = _mm512_set1_ps(1e-10f);
+    const __m512i spread_lo = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+    const __m512i spread_hi = _mm512_set_epi32(15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8, 8);
+    const float* x = reinterpret_cast<const float*>(X);
+    float* y = reinterpret_cast<float*>(out);
+
+    size_t k = 0;
+    for (; k + 16 <= num_bins; k += 16){
+        __m512 ratio = _mm512_div_ps(_mm512_loadu_ps(psd + k), _mm512_loadu_ps(psd_noise_est + k));
+        __m512 snr = _mm512_add_ps(_mm512_mul_ps(a_snr, _mm512_loadu_ps(p_SNR + k)), _mm512_mul_ps(b_snr, ratio));
+        __m512 term1 = _mm512_mul_ps(a_w, _mm512_loadu_ps(p_xi + k));
+        __m512 term2 = _mm512_mul_ps(b_w, _mm512_max_ps(floor, _mm512_sub_ps(snr, one)));
+        __m512 xi = _mm512_add_ps(term1, term2);
+        __m512 gain = _mm512_div_ps(xi, _mm512_add_ps(one, xi));
+        gain = _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(xi, xi, _CMP_ORD_Q), gain);
+
+        __m512 lo = _mm512_mul_ps(_mm512_loadu_ps(x + 2 * k), _mm512_permutexvar_ps(spread_lo, gain));
+        __m512 hi = _mm512_mul_ps(_mm512_loadu_ps(x + 2 * k + 16), _mm512_permutexvar_ps(spread_hi, gain));
+        _mm512_storeu_ps(y + 2 * k, lo);
+        _mm512_storeu_ps(y + 2 * k + 16, hi);
+
+        _mm512_storeu_ps(p_xi + k, xi);
+        _mm512_storeu_ps(p_SNR + k, snr);
+    }
+    wienerGainScalar<float>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                            alpha_w, alpha_snr);
+}
+#endif
+
+#ifdef WIENER_NEON
+// 2 bins per iteration, vmaxnmq is avoided since it drops NaN instead of propagating it
+static void wienerGainNEON(size_t num_bins, const std::complex<double>* X, const double* psd,
+                           const double* psd_noise_est, double* p_xi, double* p_SNR,
+                           std::complex<double>* out, double alpha_w, double alpha_snr){
+    const float64x2_t a_snr = vdupq_n_f64(alpha_snr);
+    const float64x2_t b_snr = vdupq_n_f64(1 - alpha_snr);
+    const float64x2_t a_w = vdupq_n_f64(alpha_w);
+    const float64x2_t b_w = vdupq_n_f64(1 - alpha_w);
+    const float64x2_t one = vdupq_n_f64(1.0);
+    const float64x2_t floor = vdupq_n_f64(1e-10);
+    const double* x = reinterpret_cast<const double*>(X);
+    double* y = reinterpret_cast<double*>(out);
+
+    size_t k = 0;
+    for (; k + 2 <= num_bins; k += 2){
+        float64x2_t ratio = vdivq_f64(vld1q_f64(psd + k), vld1q_f64(psd_noise_est + k));
+        float64x2_t snr = vaddq_f64(vmulq_f64(a_snr, vld1q_f64(p_SNR + k)), vmulq_f64(b_snr, ratio));
+        float64x2_t term1 = vmulq_f64(a_w, vld1q_f64(p_xi + k));
+        float64x2_t diff = vsubq_f64(snr, one);
+        float64x2_t clamped = vbslq_f64(vcltq_f64(diff, floor), floor, diff);
+        float64x2_t xi = vaddq_f64(term1, vmulq_f64(b_w, clamped));
+        float64x2_t gain = vdivq_f64(xi, vaddq_f64(one, xi));
+        gain = vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(gain), vceqq_f64(xi, xi)));
+
+        vst1q_f64(y + 2 * k, vmulq_laneq_f64(vld1q_f64(x + 2 * k), gain, 0));
+        vst1q_f64(y + 2 * k + 2, vmulq_laneq_f64(vld1q_f64(x + 2 * k + 2), gain, 1));
+
+        vst1q_f64(p_xi + k, xi);
+        vst1q_f64(p_SNR + k, snr);
+    }
+    wienerGainScalar<double>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                             alpha_w, alpha_snr);
+}
+
+// Single precision, 4 bins per iteration
+static void wienerGainNEONF32(size_t num_bins, const std::complex<float>* X, const float* psd,
+                              const float* psd_noise_est, float* p_xi, float* p_SNR,
+                              std::complex<float>* out, float alpha_w, float alpha_snr){
+    const float32x4_t a_snr = vdupq_n_f32(alpha_snr);
+    const float32x4_t b_snr = vdupq_n_f32(1 - alpha_snr);
+    const float32x4_t a_w = vdupq_n_f32(alpha_w);
+    const float32x4_t b_w = vdupq_n_f32(1 - alpha_w);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t floor = vdupq_n_f32(1e-10f);
+    const float* x = reinterpret_cast<const float*>(X);
+    float* y = reinterpret_cast<float*>(out);
+
+    size_t k = 0;
+    for (; k + 4 <= num_bins; k += 4){
+        float32x4_t ratio = vdivq_f32(vld1q_f32(psd + k), vld1q_f32(psd_noise_est + k));
+        float32x4_t snr = vaddq_f32(vmulq_f32(a_snr, vld1q_f32(p_SNR + k)), vmulq_f32(b_snr, ratio));
+        float32x4_t term1 = vmulq_f32(a_w, vld1q_f32(p_xi + k));
+        float32x4_t diff = vsubq_f32(snr, one);
+        float32x4_t clamped = vbslq_f32(vcltq_f32(diff, floor), floor, diff);
+        float32x4_t xi = vaddq_f32(term1, vmulq_f32(b_w, clamped));
+        float32x4_t gain = vdivq_f32(xi, vaddq_f32(one, xi));
+        gain = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(gain), vceqq_f32(xi, xi)));
+
+        vst1q_f32(y + 2 * k, vmulq_f32(vld1q_f32(x + 2 * k), vzip1q_f32(gain, gain)));
+        vst1q_f32(y + 2 * k + 4, vmulq_f32(vld1q_f32(x + 2 * k + 4), vzip2q_f32(gain, gain)));
+
+        vst1q_f32(p_xi + k, xi);
+        vst1q_f32(p_SNR + k, snr);
+    }
+    wienerGainScalar<float>(num_bins - k, X + k, psd + k, psd_noise_est + k, p_xi + k, p_SNR + k, out + k,
+                            alpha_w, alpha_snr);
+}
+#endif
+
+SimdLevel detectSimdLevel(){
+#ifdef WIENER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#elif defined(WIENER_NEON)
+    return SimdLevel::NEON;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level){
+    switch (level){
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::NEON: return "neon";
+        default: return "scalar";
+    }
+}
+
+WienerGainKernel wienerGainKernel(SimdLevel level){
+    switch (level){
+#ifdef WIENER_X86
+        case SimdLevel::AVX2: return wienerGainAVX2;
+        case SimdLevel::AVX512: return wienerGainAVX512;
+#endif
+#ifdef WIENER_NEON
+        case SimdLevel::NEON: return wienerGainNEON;
+#endif
+        default: return wienerGainScalar<double>;
+    }
+}
+
+template <>
+BasicWienerGainKernel<double> wienerGainKernel<double>(SimdLevel level){
+    return wienerGainKernel(level);
+}
+
+template <>
+BasicWienerGainKernel<float> wienerGainKernel<float>(SimdLevel level){
+    switch (level){
+#ifdef WIENER_X86
+        case SimdLevel::AVX2: return wienerGainAVX2F32;
+        case SimdLevel::AVX512: return wienerGainAVX512F32;
+#endif
+#ifdef WIENER_NEON
+        case SimdLevel::NEON: return wienerGainNEONF32;
+#endif
+        default: return wienerGainScalar<float>;
+    }
+}
@@ -0,0 +1,72 @@
+#include "window.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+const char* windowTypeName(WindowType type) {
+    switch (type) {
+        case WindowType::Hann:        return "hann";
+        case WindowType::SqrtHann:    return "sqrt-hann";
+        case WindowType::Hamming:     return "hamming";
+        case WindowType::Blackman:    return "blackman";
+        case WindowType::Rectangular: return "rect";
+    }
+    return "unknown";
+}
+
+std::vector<float> makeWindow(WindowType type, size_t frame_size, size_t hop) {
+    if (frame_size == 0 || hop == 0 || hop > frame_size) {
+        throw std::invalid_argument("Window needs a frame size and a hop between 1 and the frame size");
+    }
+    const double pi = 3.14159265358979323846;
+    std::vector<float> window(frame_size);
+    for (size_t n = 0; n < frame_size; n++) {
+        // Periodic windows, N in the denominator, so that shifted copies tile exactly
+        const double phase = 2.0 * pi * static_cast<double>(n) / static_cast<double>(frame_size);
+        double w = 1.0;
+        switch (type) {
+            case WindowType::Hann:        w = 0.5 - 0.5 * std::cos(phase); break;
+            case WindowType::SqrtHann:    w = std::sqrt(0.5 - 0.5 * std::cos(phase)); break;
+            case WindowType::Hamming:     w = 0.54 - 0.46 * std::cos(phase); break;
+            case WindowType::Blackman:    w = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase); break;
+            case WindowType::Rectangular: w = 1.0; break;
+        }
+        window[n] = static_cast<float>(w);
+    }
+    normalizeCola(window, hop);
+    return window;
+}
+
+void normalizeCola(std::vector<float>& window, size_t hop) {
+    // Output sample n of a hop receives the window values at n, n + hop, n + 2 hop, ...
+    const size_t frame_size = window.size();
+    if (hop == 0 || frame_size % hop != 0) {
+        throw std::invalid_argument("The hop must divide the window length");
+    }
+    std::vector<double> coverage(hop, 0.0);
+    double sum = 0.0;
+    for (size_t n = 0; n < frame_size; n++) {
+        coverage[n % hop] += window[n];
+        sum += window[n];
+    }
+    double lowest = coverage[0], highest = coverage[0];
+    for (double c : coverage) {
+        lowest = std::min(lowest, c);
+        highest = std::max(highest, c);
+    }
+    if (!(lowest > 1e-6 * highest)) {
+        throw std::invalid_argument("Window leaves samples without gain at this hop, use a larger overlap");
+    }
+    // The coverage of a COLA window stored in float still ripples by a few 1e-8 relative
+    if (highest - lowest <= 1e-6 * highest) {
+        // COLA already: one gain, hop / sum(w)
+        const double gain = static_cast<double>(hop) / sum;
+        for (float& w : window) {
+            w = static_cast<float>(w * gain);
+        }
+        return;
+    }
+    for (size_t n = 0; n < frame_size; n++) {
+        window[n] = static_cast<float>(window[n] / coverage[n % hop]);
+    }
+}
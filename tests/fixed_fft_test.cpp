@@ -0,0 +1,170 @@
+// Checks the fixed-point FFT:
+//  - every instruction set build (SSE2 baseline, AVX2, AVX-512, as far as the CPU supports them) gives the
+//    same mantissas and exponents as the baseline, for 16 and 32-bit words, every rounding mode, full and
+//    reduced twiddle words, and frame sizes with and without the radix-2 stage;
+//  - the forward and inverse transforms stay within a pinned SNR of pocketfft in double, so that a loss of
+//    precision shows up even when all builds agree.
+//
+// Usage: AudioFilterFixedFFTTest; exits with 1 if any check fails.
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include "fft_engine.hpp"
+#include "fixed_fft.hpp"
+
+namespace {
+
+// Levels with a kernel build of their own that the running CPU can execute, baseline first
+std::vector<SimdLevel> availableLevels() {
+    const SimdLevel best = detectSimdLevel();
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+    if (best == SimdLevel::AVX2 || best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX2);
+    if (best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX512);
+    return levels;
+}
+
+const char* roundingName(FixedRounding rounding) {
+    switch (rounding) {
+        case FixedRounding::Round: return "round";
+        case FixedRounding::RoundEven: return "round_even";
+        default: return "trunc";
+    }
+}
+
+// Mantissas and exponents of a forward and an inverse transform per input
+template <typename Word>
+struct RawRun {
+    std::vector<Word> words;
+    std::vector<int> exponents;
+    bool operator==(const RawRun& other) const { return words == other.words && exponents == other.exponents; }
+};
+
+// Raw transforms of full-scale, quiet and extreme frames with the build for level
+template <typename Word>
+RawRun<Word> runRaw(size_t frame_size, const FixedFFTConfig& config, SimdLevel level) {
+    BasicFixedPointFFT<Word> fft(frame_size, config, level);
+    std::mt19937 rng(static_cast<unsigned>(frame_size));
+    const int64_t lowest = std::numeric_limits<Word>::min();
+    const int64_t highest = std::numeric_limits<Word>::max();
+    std::vector<Word> in(frame_size), bins(2 * fft.bins()), out(frame_size);
+    RawRun<Word> run;
+    for (int64_t magnitude : {highest, highest >> 9, int64_t(3)}) {
+        std::uniform_int_distribution<int64_t> uniform(-magnitude, magnitude);
+        for (Word& v : in) v = static_cast<Word>(uniform(rng));
+        if (magnitude == highest) in[frame_size / 3] = static_cast<Word>(lowest);
+        const int exponent = fft.forward(in.data(), bins.data());
+        run.exponents.push_back(exponent);
+        run.words.insert(run.words.end(), bins.begin(), bins.end());
+        run.exponents.push_back(fft.inverse(bins.data(), exponent, out.data()));
+        run.words.insert(run.words.end(), out.begin(), out.end());
+    }
+    return run;
+}
+
+template <typename Word>
+bool checkLevels() {
+    const unsigned word_bits = 8 * sizeof(Word);
+    const std::vector<SimdLevel> levels = availableLevels();
+    bool passed = true;
+    // 128 points runs radix-4 stages only, 256 and 2048 end with the radix-2 stage
+    for (size_t frame_size : {size_t(4), size_t(8), size_t(16), size_t(128), size_t(256), size_t(2048)}) {
+        for (FixedRounding rounding : {FixedRounding::Trunc, FixedRounding::Round, FixedRounding::RoundEven}) {
+            for (unsigned twiddle_bits : {word_bits, word_bits - 4}) {
+                FixedFFTConfig config;
+                config.word_bits = word_bits;
+                config.twiddle_bits = twiddle_bits;
+                config.rounding = rounding;
+                const RawRun<Word> reference = runRaw<Word>(frame_size, config, SimdLevel::Scalar);
+                for (size_t i = 1; i < levels.size(); i++) {
+                    if (!(runRaw<Word>(frame_size, config, levels[i]) == reference)) {
+                        std::printf("FAIL %s %u-bit %s, %u-bit twiddles: %zu points differ from the baseline\n",
+                                    simdLevelName(levels[i]), word_bits, roundingName(rounding), twiddle_bits,
+                                    frame_size);
+                        passed = false;
+                    }
+                }
+            }
+        }
+    }
+    if (passed) std::printf("ok   %u-bit transforms identical on %zu instruction sets\n", word_bits, levels.size());
+    return passed;
+}
+
+struct SnrCase {
+    unsigned word_bits;
+    FixedRounding rounding;
+    size_t frame_size;
+    double min_forward_db;              // About 1.5 dB below the measured SNR
+    double min_inverse_db;
+};
+
+// Gaussian frames of standard deviation 0.3 through the fixed FFT and pocketfft, the inverse from the
+// pocketfft spectrum. Returns the SNRs of the forward and inverse results in dB.
+template <typename Word>
+std::pair<double, double> measureSnr(const SnrCase& c) {
+    FixedFFTConfig config;
+    config.word_bits = c.word_bits;
+    config.twiddle_bits = c.word_bits;
+    config.rounding = c.rounding;
+    BasicFixedPointFFT<Word> fft(c.frame_size, config);
+    FFTEngine reference(c.frame_size);
+    std::mt19937 rng(1);
+    std::normal_distribution<double> gauss(0.0, 0.3);
+    const size_t bins = c.frame_size / 2 + 1;
+    std::vector<double> in(c.frame_size), out(c.frame_size), ref_out(c.frame_size);
+    std::vector<std::complex<double>> spectrum(bins), ref_spectrum(bins);
+    double forward_error = 0, forward_signal = 0, inverse_error = 0, inverse_signal = 0;
+    for (int frame = 0; frame < 8; frame++) {
+        for (double& v : in) v = std::max(-1.0, std::min(0.999, gauss(rng)));
+        fft.forward(in.data(), spectrum.data());
+        reference.forward(in.data(), ref_spectrum.data());
+        fft.inverse(ref_spectrum.data(), out.data());
+        reference.inverse(ref_spectrum.data(), ref_out.data());
+        for (size_t k = 0; k < bins; k++) {
+            forward_error += std::norm(spectrum[k] - ref_spectrum[k]);
+            forward_signal += std::norm(ref_spectrum[k]);
+        }
+        for (size_t n = 0; n < c.frame_size; n++) {
+            inverse_error += (out[n] - ref_out[n]) * (out[n] - ref_out[n]);
+            inverse_signal += ref_out[n] * ref_out[n];
+        }
+    }
+    return {10 * std::log10(forward_signal / forward_error), 10 * std::log10(inverse_signal / inverse_error)};
+}
+
+const SnrCase kSnrCases[] = {
+    {16, FixedRounding::Trunc, 256, 55, 55.5},
+    {16, FixedRounding::RoundEven, 256, 61.5, 60},
+    {16, FixedRounding::RoundEven, 2048, 57.5, 56.5},
+    {32, FixedRounding::Trunc, 256, 151, 152},
+    {32, FixedRounding::RoundEven, 256, 158, 156.5},
+    {32, FixedRounding::RoundEven, 2048, 154, 153},
+};
+
+bool checkSnr() {
+    bool passed = true;
+    for (const SnrCase& c : kSnrCases) {
+        const std::pair<double, double> snr = c.word_bits == 16 ? measureSnr<int16_t>(c) : measureSnr<int32_t>(c);
+        const bool ok = snr.first >= c.min_forward_db && snr.second >= c.min_inverse_db;
+        std::printf("%s %u-bit %-10s %4zu points: forward %.1f dB (min %.1f), inverse %.1f dB (min %.1f)\n",
+                    ok ? "ok  " : "FAIL", c.word_bits, roundingName(c.rounding), c.frame_size, snr.first,
+                    c.min_forward_db, snr.second, c.min_inverse_db);
+        passed = ok && passed;
+    }
+    return passed;
+}
+
+} // namespace
+
+int main() {
+    bool passed = checkLevels<int16_t>();
+    passed = checkLevels<int32_t>() && passed;
+    passed = checkSnr() && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+# Prints the expected values of tests/fixed_point_test.cpp, computed with FixedPointValue of
+# python/quant_tool.py: raw words of FixedPointFormat::quantize(), and the filtered spectrum of
+# FixedPointWienerFilter, whose two divisions and every rounding are done here on exact fractions.
+#
+# Usage: python tests/fixed_point_cases.py
+import os
+import sys
+from fractions import Fraction
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'python'))
+from quant_tool import FixedPointValue
+
+ROUNDING = {'trunc': 'FixedRounding::Trunc', 'round': 'FixedRounding::Round', 'round_even': 'FixedRounding::RoundEven'}
+OVERFLOW = {'saturate': 'FixedOverflow::Saturate', 'wrap': 'FixedOverflow::Wrap'}
+
+# (total bits, fraction bits, signed, rounding, overflow, value)
+QUANTIZE_CASES = [
+    (16, 15, True, 'trunc', 'saturate', 0.5),
+    (16, 15, True, 'trunc', 'saturate', -0.3),
+    (16, 15, True, 'round', 'saturate', 0.999999),
+    (16, 15, True, 'round_even', 'saturate', 2.5 / 32768),
+    (16, 15, True, 'round_even', 'saturate', 3.5 / 32768),
+    (16, 15, True, 'round_even', 'saturate', -2.5 / 32768),
+    (16, 15, True, 'trunc', 'wrap', 1.25),
+    (16, 15, True, 'round', 'wrap', -1.5),
+    (32, 16, True, 'trunc', 'saturate', 40000.0),
+    (32, 16, True, 'trunc', 'wrap', 40000.0),
+    (16, 8, False, 'round', 'saturate', -3.0),
+    (16, 8, False, 'trunc', 'wrap', 300.75),
+    (32, 31, True, 'round_even', 'saturate', 0.1),
+    (12, 4, True, 'round_even', 'wrap', -200.03125),
+]
+
+
+class Format:
+    def __init__(self, total, frac, rounding, overflow):
+        self.total, self.frac, self.rounding, self.overflow = total, frac, rounding, overflow
+
+    # Raw word of the exact value
+    def fit(self, value):
+        return FixedPointValue(self.total, self.frac, value, True, self.rounding, self.overflow).value
+
+    def lsb(self, raw):
+        return Fraction(raw, 2 ** self.frac)
+
+
+def q15(rounding, overflow, ratio_rounding=None, ratio_overflow=None):
+    return {'data': Format(16, 15, rounding, overflow),
+            'power': Format(32, 30, rounding, overflow),
+            'ratio': Format(32, 16, ratio_rounding or rounding, ratio_overflow or overflow),
+            'gain': Format(16, 15, rounding, overflow),
+            'coef': Format(16, 14, rounding, overflow)}
+
+
+# Frames of bins (re, im, psd, noise), raw data and power words
+WIENER_FRAMES = [
+    [(12000, -7000, 620000000, 41000000), (-3, 5, 1, 1), (32767, -32768, 2147483647, 3), (250, 100, 3000000, 1000000)],
+    [(-9000, 1500, 400000000, 39000000), (7, -7, 3, 2), (-32768, 32767, 2147483647, 1), (-17, 23, 5000000, 1300000)],
+]
+
+# (rounding, overflow of every format, then of the ratio format alone when it differs)
+WIENER_MODES = [
+    ('trunc', 'saturate', None, None),
+    ('trunc', 'wrap', None, None),
+    ('round', 'saturate', None, None),
+    ('round', 'wrap', None, None),
+    ('trunc', 'saturate', 'round', 'wrap'),
+]
+
+
+# FixedPointWienerFilter::apply() on every frame of WIENER_FRAMES, returns the raw filtered words
+def wiener(config):
+    data, ratio, gain, coef = config['data'], config['ratio'], config['gain'], config['coef']
+    alpha_w, one_minus_alpha_w = coef.fit(0.35), coef.fit(1 - 0.35)
+    alpha_snr, one_minus_alpha_snr = coef.fit(0.15), coef.fit(1 - 0.15)
+    one, xi_floor = ratio.fit(1.0), ratio.fit(1e-10)
+    bins = len(WIENER_FRAMES[0])
+    p_xi, p_snr = [0] * bins, [ratio.fit(1e-10)] * bins
+    frames = []
+    for frame in WIENER_FRAMES:
+        out = []
+        for k, (re, im, psd, noise) in enumerate(frame):
+            ratio_k = ratio.fit(Fraction(psd, noise))
+            snr = ratio.fit(coef.lsb(alpha_snr) * ratio.lsb(p_snr[k]) + coef.lsb(one_minus_alpha_snr) * ratio.lsb(ratio_k))
+            excess = max(ratio.fit(ratio.lsb(snr - one)), xi_floor)
+            p_xi[k] = ratio.fit(coef.lsb(alpha_w) * ratio.lsb(p_xi[k]) + coef.lsb(one_minus_alpha_w) * ratio.lsb(excess))
+            p_snr[k] = snr
+            g = gain.fit(Fraction(p_xi[k], ratio.fit(ratio.lsb(one + p_xi[k]))))
+            out += [data.fit(data.lsb(re) * gain.lsb(g)), data.fit(data.lsb(im) * gain.lsb(g))]
+        frames.append(out)
+    return frames
+
+
+def main():
+    print('// Generated by tests/fixed_point_cases.py')
+    print('const QuantizeCase kQuantizeCases[] = {')
+    for total, frac, signed, rounding, overflow, value in QUANTIZE_CASES:
+        raw = FixedPointValue(total, frac, value, signed, rounding, overflow).value
+        print(f'    {{{{{total}, {frac}, {"true" if signed else "false"}, {ROUNDING[rounding]}, {OVERFLOW[overflow]}}}, '
+              f'{value!r}, {raw}}},')
+    print('};')
+    print()
+    rows = lambda values: '{' + ', '.join('{' + ', '.join(str(v) for v in row) + '}' for row in values) + '}'
+    print(f'const int32_t kWienerSpectrum[kWienerFrames][2 * kWienerBins] = '
+          f'{rows([[v for re, im, _, _ in frame for v in (re, im)] for frame in WIENER_FRAMES])};')
+    print(f'const int32_t kWienerPSD[kWienerFrames][kWienerBins] = {rows([[b[2] for b in frame] for frame in WIENER_FRAMES])};')
+    print(f'const int32_t kWienerNoise[kWienerFrames][kWienerBins] = {rows([[b[3] for b in frame] for frame in WIENER_FRAMES])};')
+    print()
+    print('const WienerCase kWienerCases[] = {')
+    for rounding, overflow, ratio_rounding, ratio_overflow in WIENER_MODES:
+        frames = wiener(q15(rounding, overflow, ratio_rounding, ratio_overflow))
+        modes = f'{ROUNDING[rounding]}, {OVERFLOW[overflow]}, {ROUNDING[ratio_rounding or rounding]}, {OVERFLOW[ratio_overflow or overflow]}'
+        print(f'    {{{modes},')
+        print('     {' + ',\n      '.join('{' + ', '.join(str(v) for v in out) + '}' for out in frames) + '}},')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,232 @@
+// Checks the fixed-point noise estimator and Wiener filter kernels:
+//  - every instruction set build (SSE2 baseline, AVX2, AVX-512, as far as the CPU supports them) gives the
+//    same words as the baseline for every rounding and overflow mode, in q15 and q31, and for a
+//    configuration mixing modes, on random spectra that also overflow the data format;
+//  - FixedPointFormat::quantize() and the two divisions of FixedPointWienerFilter give the values of
+//    FixedPointValue in python/quant_tool.py, computed by tests/fixed_point_cases.py.
+//
+// Usage: AudioFilterFixedPointTest; exits with 1 if any check fails.
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "fixed_point.hpp"
+
+namespace {
+
+// Levels with a kernel build of their own that the running CPU can execute, baseline first
+std::vector<SimdLevel> availableLevels() {
+    const SimdLevel best = detectSimdLevel();
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+    if (best == SimdLevel::AVX2 || best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX2);
+    if (best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX512);
+    return levels;
+}
+
+const char* roundingName(FixedRounding rounding) {
+    switch (rounding) {
+        case FixedRounding::Round: return "round";
+        case FixedRounding::RoundEven: return "round_even";
+        default: return "trunc";
+    }
+}
+
+const char* overflowName(FixedOverflow overflow) {
+    return overflow == FixedOverflow::Wrap ? "wrap" : "saturate";
+}
+
+// Outputs of a FixedPointStage over a run of frames, every value converted back from words
+template <typename T>
+struct StageRun {
+    std::vector<T> psd, noise, filtered;
+};
+
+// The same frames through the stage built for level: quantization, |X|², noise estimate and Wiener gain
+template <typename T>
+StageRun<T> runStage(const FixedPointConfig& config, SimdLevel level, size_t num_bins, size_t frames) {
+    const size_t d = 4;                         // Short minimum statistics window, so blocks end often
+    FixedPointStage<T> stage(num_bins, d, config, level);
+    std::mt19937 rng(static_cast<unsigned>(num_bins));
+    // Spectra up to 1.5 in magnitude overflow the data format, NaN quantizes to 0
+    std::uniform_real_distribution<T> uniform(T(-1.5), T(1.5));
+    std::vector<std::complex<T>> spectrum(num_bins), filtered(num_bins);
+    std::vector<T> psd(num_bins);
+    StageRun<T> run;
+    for (size_t frame = 0; frame < frames; frame++) {
+        const T amplitude = (frame % 3 == 0) ? T(1) : T(0.01);
+        for (size_t k = 0; k < num_bins; k++) {
+            spectrum[k] = {uniform(rng) * amplitude, uniform(rng) * amplitude};
+        }
+        if (frame == 5) spectrum[num_bins / 2] = {std::numeric_limits<T>::quiet_NaN(), T(0)};
+        stage.estimateNoise(spectrum.data(), psd.data());
+        stage.filterSpectrum(filtered.data());
+        run.psd.insert(run.psd.end(), psd.begin(), psd.end());
+        run.noise.insert(run.noise.end(), stage.getNoiseEstimate().begin(), stage.getNoiseEstimate().end());
+        for (const std::complex<T>& bin : filtered) {
+            run.filtered.push_back(bin.real());
+            run.filtered.push_back(bin.imag());
+        }
+    }
+    return run;
+}
+
+template <typename T>
+bool sameRun(const StageRun<T>& a, const StageRun<T>& b) {
+    auto same = [](const std::vector<T>& x, const std::vector<T>& y) {
+        return x.size() == y.size() && std::memcmp(x.data(), y.data(), x.size() * sizeof(T)) == 0;
+    };
+    return same(a.psd, b.psd) && same(a.noise, b.noise) && same(a.filtered, b.filtered);
+}
+
+// Every instruction set against the baseline for one configuration
+bool checkLevels(const FixedPointConfig& config, const char* name) {
+    const std::vector<SimdLevel> levels = availableLevels();
+    bool passed = true;
+    for (size_t num_bins : {size_t(7), size_t(129)}) {
+        const StageRun<double> reference = runStage<double>(config, SimdLevel::Scalar, num_bins, 24);
+        const StageRun<float> reference_float = runStage<float>(config, SimdLevel::Scalar, num_bins, 24);
+        for (size_t i = 1; i < levels.size(); i++) {
+            if (!sameRun(reference, runStage<double>(config, levels[i], num_bins, 24)) ||
+                !sameRun(reference_float, runStage<float>(config, levels[i], num_bins, 24))) {
+                std::printf("FAIL %s %s: %zu bins differ from the baseline kernels\n", simdLevelName(levels[i]),
+                            name, num_bins);
+                passed = false;
+            }
+        }
+    }
+    return passed;
+}
+
+bool checkAllModes() {
+    bool passed = true;
+    for (bool q31 : {false, true}) {
+        for (FixedRounding rounding : {FixedRounding::Trunc, FixedRounding::Round, FixedRounding::RoundEven}) {
+            for (FixedOverflow overflow : {FixedOverflow::Saturate, FixedOverflow::Wrap}) {
+                FixedPointConfig config = q31 ? FixedPointConfig::q31() : FixedPointConfig::q15();
+                config.setRounding(rounding);
+                config.setOverflow(overflow);
+                char name[64];
+                std::snprintf(name, sizeof(name), "%s %s %s", q31 ? "q31" : "q15", roundingName(rounding),
+                              overflowName(overflow));
+                passed = checkLevels(config, name) && passed;
+            }
+        }
+    }
+    // Different modes per format take the generic kernels
+    FixedPointConfig mixed = FixedPointConfig::q15();
+    mixed.ratio.rounding = FixedRounding::RoundEven;
+    mixed.power.overflow = FixedOverflow::Wrap;
+    passed = checkLevels(mixed, "q15 mixed") && passed;
+    if (passed) std::printf("ok   kernels identical on %zu instruction sets\n", availableLevels().size());
+    return passed;
+}
+
+struct QuantizeCase {
+    FixedPointFormat format;
+    double value;
+    int32_t raw;
+};
+
+const size_t kWienerFrames = 2;
+const size_t kWienerBins = 4;
+
+struct WienerCase {
+    FixedRounding rounding;
+    FixedOverflow overflow;
+    FixedRounding ratio_rounding;
+    FixedOverflow ratio_overflow;
+    int32_t filtered[kWienerFrames][2 * kWienerBins];
+};
+
+// Generated by tests/fixed_point_cases.py
+const QuantizeCase kQuantizeCases[] = {
+    {{16, 15, true, FixedRounding::Trunc, FixedOverflow::Saturate}, 0.5, 16384},
+    {{16, 15, true, FixedRounding::Trunc, FixedOverflow::Saturate}, -0.3, -9831},
+    {{16, 15, true, FixedRounding::Round, FixedOverflow::Saturate}, 0.999999, 32767},
+    {{16, 15, true, FixedRounding::RoundEven, FixedOverflow::Saturate}, 7.62939453125e-05, 2},
+    {{16, 15, true, FixedRounding::RoundEven, FixedOverflow::Saturate}, 0.0001068115234375, 4},
+    {{16, 15, true, FixedRounding::RoundEven, FixedOverflow::Saturate}, -7.62939453125e-05, -2},
+    {{16, 15, true, FixedRounding::Trunc, FixedOverflow::Wrap}, 1.25, -24576},
+    {{16, 15, true, FixedRounding::Round, FixedOverflow::Wrap}, -1.5, 16384},
+    {{32, 16, true, FixedRounding::Trunc, FixedOverflow::Saturate}, 40000.0, 2147483647},
+    {{32, 16, true, FixedRounding::Trunc, FixedOverflow::Wrap}, 40000.0, -1673527296},
+    {{16, 8, false, FixedRounding::Round, FixedOverflow::Saturate}, -3.0, 0},
+    {{16, 8, false, FixedRounding::Trunc, FixedOverflow::Wrap}, 300.75, 11456},
+    {{32, 31, true, FixedRounding::RoundEven, FixedOverflow::Saturate}, 0.1, 214748365},
+    {{12, 4, true, FixedRounding::RoundEven, FixedOverflow::Wrap}, -200.03125, 896},
+};
+
+const int32_t kWienerSpectrum[kWienerFrames][2 * kWienerBins] = {{12000, -7000, -3, 5, 32767, -32768, 250, 100}, {-9000, 1500, 7, -7, -32768, 32767, -17, 23}};
+const int32_t kWienerPSD[kWienerFrames][kWienerBins] = {{620000000, 1, 2147483647, 3000000}, {400000000, 3, 2147483647, 5000000}};
+const int32_t kWienerNoise[kWienerFrames][kWienerBins] = {{41000000, 1, 3, 1000000}, {39000000, 2, 1, 1300000}};
+
+const WienerCase kWienerCases[] = {
+    {FixedRounding::Trunc, FixedOverflow::Saturate, FixedRounding::Trunc, FixedOverflow::Saturate,
+     {{10621, -6196, 0, 0, 32765, -32766, 125, 50},
+      {-8097, 1349, 1, -2, -32766, 32765, -12, 15}}},
+    {FixedRounding::Trunc, FixedOverflow::Wrap, FixedRounding::Trunc, FixedOverflow::Wrap,
+     {{10621, -6196, 0, 0, 0, 0, 125, 50},
+      {-8097, 1349, 1, -2, 0, 0, -12, 15}}},
+    {FixedRounding::Round, FixedOverflow::Saturate, FixedRounding::Round, FixedOverflow::Saturate,
+     {{10622, -6196, 0, 0, 32765, -32766, 125, 50},
+      {-8097, 1349, 1, -1, -32767, 32766, -11, 16}}},
+    {FixedRounding::Round, FixedOverflow::Wrap, FixedRounding::Round, FixedOverflow::Wrap,
+     {{10622, -6196, 0, 0, 0, 0, 125, 50},
+      {-8097, 1349, 1, -1, 0, 0, -11, 16}}},
+    {FixedRounding::Trunc, FixedOverflow::Saturate, FixedRounding::Round, FixedOverflow::Wrap,
+     {{10621, -6196, 0, 0, 0, 0, 125, 50},
+      {-8097, 1349, 1, -2, 0, 0, -12, 15}}},
+};
+
+bool checkQuantize() {
+    bool passed = true;
+    for (const QuantizeCase& c : kQuantizeCases) {
+        const int32_t raw = c.format.quantize(c.value);
+        if (raw != c.raw) {
+            std::printf("FAIL quantize %.17g to %c(%u, %u) %s %s: %d, quant_tool.py gives %d\n", c.value,
+                        c.format.is_signed ? 'S' : 'U', c.format.total_bits - c.format.frac_bits, c.format.frac_bits,
+                        roundingName(c.format.rounding), overflowName(c.format.overflow), raw, c.raw);
+            passed = false;
+        }
+    }
+    if (passed) std::printf("ok   quantize matches quant_tool.py\n");
+    return passed;
+}
+
+bool checkWiener() {
+    bool passed = true;
+    for (const WienerCase& c : kWienerCases) {
+        FixedPointConfig config = FixedPointConfig::q15();
+        config.setRounding(c.rounding);
+        config.setOverflow(c.overflow);
+        config.ratio.rounding = c.ratio_rounding;
+        config.ratio.overflow = c.ratio_overflow;
+        for (SimdLevel level : availableLevels()) {
+            FixedPointWienerFilter filter(kWienerBins, config, level);
+            for (size_t frame = 0; frame < kWienerFrames; frame++) {
+                int32_t filtered[2 * kWienerBins];
+                filter.apply(kWienerSpectrum[frame], kWienerPSD[frame], kWienerNoise[frame], filtered);
+                if (std::memcmp(filtered, c.filtered[frame], sizeof(filtered)) != 0) {
+                    std::printf("FAIL wiener %s %s, ratio %s %s, %s: frame %zu differs from quant_tool.py\n",
+                                roundingName(c.rounding), overflowName(c.overflow), roundingName(c.ratio_rounding),
+                                overflowName(c.ratio_overflow), simdLevelName(level), frame);
+                    passed = false;
+                }
+            }
+        }
+    }
+    if (passed) std::printf("ok   wiener divisions match quant_tool.py\n");
+    return passed;
+}
+
+} // namespace
+
+int main() {
+    bool passed = checkAllModes();
+    passed = checkQuantize() && passed;
+    passed = checkWiener() && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// Checks that every Wiener gain kernel the running CPU supports matches the scalar kernel bit for bit
+// (any NaN matching any NaN), in double and in float, over several frames of random spectra mixed with
+// NaN, zero and denormal values. The recursive p_xi/p_SNR state is carried from frame to frame, so a
+// difference in one frame also shows up in the next ones.
+//
+// Usage: AudioFilterWienerKernelTest; exits with 1 if any kernel differs.
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "wiener_kernel.hpp"
+
+namespace {
+
+// Levels with a kernel of their own that the running CPU can execute
+std::vector<SimdLevel> availableLevels() {
+    const SimdLevel best = detectSimdLevel();
+    if (best == SimdLevel::NEON) return {SimdLevel::NEON};
+    std::vector<SimdLevel> levels;
+    if (best == SimdLevel::AVX2 || best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX2);
+    if (best == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX512);
+    return levels;
+}
+
+// Mostly ordinary values in [0, scale), with 3 in 16 replaced by NaN, zero or a denormal (1 in 16 each)
+template <typename T>
+T specialValue(std::mt19937& rng, T scale) {
+    std::uniform_real_distribution<T> uniform(T(0), scale);
+    switch (rng() % 16) {
+        case 0: return std::numeric_limits<T>::quiet_NaN();
+        case 1: return T(0);
+        case 2: return std::numeric_limits<T>::denorm_min() * static_cast<T>(1 + rng() % 1000);
+        default: return uniform(rng);
+    }
+}
+
+// Bit for bit, except that any two NaNs are equal: when both operands of an instruction are NaN the
+// hardware returns one of them, and which one depends on the operand order the compiler picked
+template <typename T>
+bool sameBits(T a, T b) {
+    return (std::isnan(a) && std::isnan(b)) || std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <typename T>
+bool sameBits(const T* a, const T* b, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!sameBits(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool sameBits(const std::complex<T>* a, const std::complex<T>* b, size_t count) {
+    return sameBits(reinterpret_cast<const T*>(a), reinterpret_cast<const T*>(b), 2 * count);
+}
+
+// Runs the scalar kernel and the one of level side by side on identical inputs and state
+template <typename T>
+bool checkLevel(SimdLevel level, const char* precision) {
+    const BasicWienerGainKernel<T> reference = wienerGainKernel<T>(SimdLevel::Scalar);
+    const BasicWienerGainKernel<T> kernel = wienerGainKernel<T>(level);
+    const size_t frames = 32;
+    std::mt19937 rng(20240611);
+
+    // Odd bin counts exercise the scalar tail after the vector loop
+    for (size_t num_bins : {size_t(1), size_t(7), size_t(65), size_t(129), size_t(1025)}) {
+        std::vector<T> ref_xi(num_bins, T(0)), ref_snr(num_bins, T(1e-10));
+        std::vector<T> xi(ref_xi), snr(ref_snr);
+        std::vector<std::complex<T>> X(num_bins), ref_out(num_bins), out(num_bins);
+        std::vector<T> psd(num_bins), noise(num_bins);
+
+        for (size_t frame = 0; frame < frames; frame++) {
+            for (size_t k = 0; k < num_bins; k++) {
+                const T sign_re = (rng() & 1) ? T(1) : T(-1);
+                const T sign_im = (rng() & 1) ? T(1) : T(-1);
+                X[k] = {sign_re * specialValue<T>(rng, T(1)), sign_im * specialValue<T>(rng, T(1))};
+                psd[k] = specialValue<T>(rng, T(1));
+                noise[k] = specialValue<T>(rng, T(1e-2));
+            }
+            reference(num_bins, X.data(), psd.data(), noise.data(), ref_xi.data(), ref_snr.data(),
+                      ref_out.data(), T(0.35), T(0.15));
+            // Every other frame in place, as BasicWienerFilter allows
+            std::complex<T>* target = (frame % 2) ? X.data() : out.data();
+            kernel(num_bins, X.data(), psd.data(), noise.data(), xi.data(), snr.data(), target, T(0.35),
+                   T(0.15));
+
+            if (!sameBits(ref_out.data(), target, num_bins) || !sameBits(ref_xi.data(), xi.data(), num_bins) ||
+                !sameBits(ref_snr.data(), snr.data(), num_bins)) {
+                std::printf("FAIL %s %s: %zu bins, frame %zu differs from the scalar kernel\n",
+                            simdLevelName(level), precision, num_bins, frame);
+                return false;
+            }
+        }
+    }
+    std::printf("ok   %s %s\n", simdLevelName(level), precision);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const std::vector<SimdLevel> levels = availableLevels();
+    if (levels.empty()) {
+        std::printf("No SIMD kernel available on this CPU, nothing to compare\n");
+        return 0;
+    }
+    bool passed = true;
+    for (SimdLevel level : levels) {
+        passed = checkLevel<double>(level, "double") && passed;
+        passed = checkLevel<float>(level, "float") && passed;
+    }
+    return passed ? 0 : 1;
+}
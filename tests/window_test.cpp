@@ -0,0 +1,99 @@
+// Checks the COLA normalization of the generated windows: a window that is COLA at its hop must come out
+// as a pure rescale of its raw formula, one gain hop / sum(w) for every sample; the others must overlap-add
+// to 1; and a hop that leaves samples without gain must be rejected.
+//
+// Usage: AudioFilterWindowTest; exits with 1 if any check fails.
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include "window.hpp"
+
+namespace {
+
+// The periodic window formula of makeWindow(), before normalization
+std::vector<float> rawWindow(WindowType type, size_t frame_size) {
+    const double pi = 3.14159265358979323846;
+    std::vector<float> window(frame_size);
+    for (size_t n = 0; n < frame_size; n++) {
+        const double phase = 2.0 * pi * static_cast<double>(n) / static_cast<double>(frame_size);
+        double w = 1.0;
+        switch (type) {
+            case WindowType::Hann:        w = 0.5 - 0.5 * std::cos(phase); break;
+            case WindowType::SqrtHann:    w = std::sqrt(0.5 - 0.5 * std::cos(phase)); break;
+            case WindowType::Hamming:     w = 0.54 - 0.46 * std::cos(phase); break;
+            case WindowType::Blackman:    w = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase); break;
+            case WindowType::Rectangular: w = 1.0; break;
+        }
+        window[n] = static_cast<float>(w);
+    }
+    return window;
+}
+
+struct Case {
+    WindowType type;
+    size_t overlap;                     // Frames covering each sample, the hop is frame_size / overlap
+    bool cola;                          // COLA at that hop before normalization
+};
+
+const Case kCases[] = {
+    {WindowType::Hann, 2, true},     {WindowType::Hann, 4, true},     {WindowType::Hann, 8, true},
+    {WindowType::Hamming, 2, true},  {WindowType::Hamming, 4, true},  {WindowType::Hamming, 8, true},
+    {WindowType::Blackman, 4, true}, {WindowType::Blackman, 8, true}, {WindowType::Rectangular, 1, true},
+    {WindowType::Rectangular, 2, true}, {WindowType::SqrtHann, 2, false}, {WindowType::SqrtHann, 4, false},
+    {WindowType::Blackman, 2, false},
+};
+
+bool checkCase(const Case& c, size_t frame_size) {
+    const size_t hop = frame_size / c.overlap;
+    const std::vector<float> window = makeWindow(c.type, frame_size, hop);
+    if (c.cola) {
+        const std::vector<float> raw = rawWindow(c.type, frame_size);
+        double sum = 0.0;
+        for (float w : raw) sum += w;
+        const double gain = static_cast<double>(hop) / sum;
+        for (size_t n = 0; n < frame_size; n++) {
+            if (window[n] != static_cast<float>(raw[n] * gain)) {
+                std::printf("FAIL %s, %zu points, hop %zu: sample %zu is not the raw window times %.17g\n",
+                            windowTypeName(c.type), frame_size, hop, n, gain);
+                return false;
+            }
+        }
+    }
+    for (size_t i = 0; i < hop; i++) {
+        double coverage = 0.0;
+        for (size_t n = i; n < frame_size; n += hop) coverage += window[n];
+        if (std::fabs(coverage - 1.0) > 1e-6) {
+            std::printf("FAIL %s, %zu points, hop %zu: overlap-add gain %.9f at sample %zu\n",
+                        windowTypeName(c.type), frame_size, hop, coverage, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool checkRejected(WindowType type, size_t frame_size, size_t hop) {
+    try {
+        makeWindow(type, frame_size, hop);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    std::printf("FAIL %s, %zu points, hop %zu: accepted a hop that leaves samples without gain\n",
+                windowTypeName(type), frame_size, hop);
+    return false;
+}
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    for (size_t frame_size : {size_t(64), size_t(256), size_t(8192)}) {
+        for (const Case& c : kCases) {
+            passed = checkCase(c, frame_size) && passed;
+        }
+        passed = checkRejected(WindowType::Hann, frame_size, frame_size) && passed;
+        passed = checkRejected(WindowType::Blackman, frame_size, frame_size) && passed;
+    }
+    if (passed) std::printf("ok   COLA windows only rescaled, every window overlap-adds to 1\n");
+    return passed ? 0 : 1;
+}